@@ -14,16 +14,30 @@
 #include "external_eeprom.h"
 #include "pir.h"
 #include "twi.h"
-#include "string.h"
 #include "util/delay.h"
-#include "timer.h"
+#include "rtc.h"
+#include "schedule.h"
+#include "config.h"
+#include "secure_link.h"
+#include "users.h"
+#include "lockout.h"
+#include "audit.h"
+#include "secure_compare.h"
+#include "trace.h"
+#include "probe.h"
+#include "stack_monitor.h"
+#include "power.h"
+#include "frame_pool.h"
+#include "avr/pgmspace.h"
 
 
 /*******************************************************************************
  *                                Definitions                                  *
  *******************************************************************************/
 
-#define PASSWORD_SIZE				5
+/* PINs are 4 to 12 digits, their length is carried by the secure link frame */
+#define PASSWORD_MIN_SIZE			4
+#define PASSWORD_MAX_SIZE			12
 #define PASSWORD_SAVED 				0x11
 #define DIFF_PASSWORDS				0x22
 #define TRUE_PASSWORD				0x33
@@ -32,24 +46,117 @@
 #define LOCKING_DOOR				0x44
 #define UNLOCK_DOOR    				0x55
 #define CHANGE_PASSWORD				0xE3
+#define BAUD_REQUEST				0x66
+#define BAUD_ACCEPTED				0x67
+#define BAUD_REJECTED				0x68
+#define ENROLL_USER					0x71
+#define REVOKE_USER					0x72
+#define ACCESS_GRANTED				0x73
+#define ACCESS_DENIED				0x74
+#define USER_SLOT_OK				0x75
+#define USER_SLOT_INVALID			0x76
+#define ALARM_MODE					0x53
+#define LOGIN_REQUEST				0x81
+#define LOCKOUT_STATUS				0x82
+#define HEARTBEAT					0x83
+#define HEARTBEAT_ACK				0x84
+#define SYSTEM_SETUP				0x85
+#define SETUP_REQUIRED				0x86
+#define SETUP_DONE					0x87
+#define AUDIT_DUMP					0x88
+#define SET_TIME					0x89
+#define TIME_ACCEPTED				0x8A
+#define TIME_INVALID				0x8B
+#define GET_TIME					0x8C
+#define SCHEDULE_EDIT				0x8D
+#define SCHEDULE_OK					0x8E
+#define SCHEDULE_INVALID			0x8F
+#define OUT_OF_SCHEDULE				0x90
+#define CONFIG_READ					0x91
+#define CONFIG_EDIT					0x92
+#define DOOR_UNLOCKED				0x93
+#define DOOR_LOCKED					0x94
+#define CONFIG_OK					0x95
+#define CONFIG_INVALID				0x96
+#define TRACE_DUMP					0x97
+#define PROBE_DUMP					0x98
+#define RAM_REPORT					0x99
+#define PASSWORD_NOT_SAVED			0x9C
+#define LOGIN_ABORTED				0x9D
+
+/* Password pairs received before a new password is given up */
+#define PASSWORD_SAVE_ATTEMPTS		3
+
+/* key frame sent by HMI_ECU for every key pressed during a login : key ('0' to '9' for the digits) */
+#define LOGIN_KEY_ENTER				'='
+
+/* date and time frame sent by HMI_ECU : year since 2000 | month | day | hours | minutes | seconds */
+#define TIME_FRAME_SIZE				6
+
+/*
+ * schedule frame sent by HMI_ECU : operation | 7 parameters
+ * rule   : profile | first day | last day | start hour | start minute | end hour | end minute
+ * clear  : profile
+ * assign : user slot | profile
+ */
+#define SCHEDULE_FRAME_SIZE			8
+#define SCHEDULE_OP_RULE			0
+#define SCHEDULE_OP_CLEAR			1
+#define SCHEDULE_OP_ASSIGN			2
+
+/* configuration frame sent by HMI_ECU : field | value (2 bytes, big endian) */
+#define CONFIG_FRAME_SIZE			3
+
+/*
+ * Uncomment to answer AUDIT_DUMP, TRACE_DUMP and PROBE_DUMP, in debug builds only:
+ * the dumps are sent in plain text to anyone on the UART, without a login.
+ */
+//#define DIAGNOSTICS_ENABLED
+
+/* Longest wait for the parameter byte of a command */
+#define COMMAND_BYTE_TIMEOUT_MS		20
+
+/* Longest wait for the answer to a proposed baud rate, and proposals of one rate before falling back to the base rate */
+#define BAUD_ANSWER_TIMEOUT_MS		50
+#define BAUD_REQUEST_ATTEMPTS		3
+
+
+/* a new password frame must fit in one secure link frame */
+#if (PASSWORD_MAX_SIZE > SECURE_LINK_MAX_PAYLOAD)
+#error "PASSWORD_MAX_SIZE doesn't fit in a secure link frame"
+#endif
 
 
 /*******************************************************************************
  *                           Global Variables                                  *
  *******************************************************************************/
 
-volatile uint8 tick = 0;
-volatile boolean t_15s_flag = FALSE;
-volatile boolean t_60s_flag = FALSE;
-volatile boolean alarm_flag = FALSE;
-
+/*
+ * Login in progress : the record of the user is read when the user id arrives,
+ * and every PIN digit is hashed when it arrives, so only the end of the hash is left after '='.
+ */
+static Password_VerifierType g_loginVerifier;
+static uint8 g_loginSlot = LOCKOUT_NO_SLOT;
+static uint8 g_loginDigits = 0;
 
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
 
-void getAndSavePassword(void);
-void timerCallBack(void);
+void processCommand(uint8 command);
+boolean beginLogin(void);
+boolean receivePin(void);
+void finishLogin(void);
+void openDoor(void);
+uint8 getAndSavePassword(uint8 slot);
+void manageUsers(uint8 action, uint8 slot);
+void setTime(uint8 slot);
+void editSchedule(uint8 slot);
+void editConfig(uint8 slot);
+void negotiateBaudRate(void);
+FramePool_FrameType * receiveFrame(void);
+boolean receiveFrameByte(uint8 * value);
+void rotateMotor(DcMotor_State state, uint8 speed);
 
 
 /*******************************************************************************
@@ -57,19 +164,15 @@ void timerCallBack(void);
  *******************************************************************************/
 
 int main(void){
-	uint8 size = PASSWORD_SIZE + 1;
-	uint8 enteredPass[size] , savedPass[size];
-	uint8 action = 0;
-	/* Create configuration structure for timer driver */
-	Timer_ConfigType timerConfig = {0,39062,TIMER1_ID,F_CPU_1024,COMPARE_MODE};
+	uint32 second_start;
 	/* Create configuration structure for UART driver */
-	UART_ConfigType uartConfig = {DATA_8_BIT,DISABLED,ONE_BIT,9600};
+	UART_ConfigType uartConfig = {DATA_8_BIT,DISABLED,ONE_BIT,UART_BASE_BAUD_RATE};
 
 	/* Enable Global Interrupt */
 	SREG_REG.bits.I_bit = LOGIC_HIGH;
 
 	/* Initialize the UART driver with :
-	 * Baud-rate = 9600 bits/sec
+	 * Baud-rate = 9600 bits/sec (base rate until the speed negotiation)
 	 * one stop bit
 	 * No parity
 	 * 8-bit data
@@ -83,6 +186,15 @@ int main(void){
 	 * bite rate = 0x02    so SCL frequency= 400 bit/s
 	 */
 	TWI_init(&twiConfig);
+	/* Load the site configuration from the External EEPROM */
+	Config_init();
+
+	/* Move both ECUs to the fastest baud rate they support */
+	negotiateBaudRate();
+	/* Load the link key and nonce counters from the internal EEPROM */
+	SecureLink_init();
+	/* The received frames are taken from the frame pool */
+	FramePool_init();
 
 	/* Initialize the Buzzer */
 	Buzzer_init();
@@ -90,133 +202,354 @@ int main(void){
 	DcMotor_Init();
 	/* Initialize the PIR Sensor */
 	PIR_init();
+	/* Start the 1 ms tick and the calendar clock */
+	RTC_init();
+	Trace_record(TRACE_EVENT_BOOT,0);
+	/* Start Timer1 for the execution time probes if they are enabled */
+	Probe_init();
+	/* Build the RAM index of the active user slots */
+	Users_init();
+	/* Load the schedule profile of every user slot */
+	Schedule_init();
+	/* Load the wrong password counters, a lockout interrupted by a reset starts again */
+	Lockout_init();
+	if(Lockout_isLocked()){
+		Buzzer_on();
+	}
+	/* Find the newest audit record and log the start up */
+	Audit_init();
+	Audit_append(RTC_getEpoch(),AUDIT_EVENT_BOOT,AUDIT_NO_SLOT,AUDIT_RESULT_OK);
 
-	/* Get the password from HMI_ECU and save it in the External EEPRPOM */
-	getAndSavePassword();
-	_delay_ms(10);
-
+	second_start = RTC_getMilliseconds();
 	for(;;){
-		uint8 loop_counter;
-
-		/* loop 3 times until the user enter the true password */
-		for(loop_counter=0 ; loop_counter<3 ; loop_counter++){
-			/* Send CONTROL_ECU_READY byte to HMI_ECU to ask it to send the password */
-			UART_sendByte(CONTROL_ECU_READY);
-			/* Receive the password from HMI_ECU through UART */
-			UART_receiveString(enteredPass);
-
-			/* get the password saved in the EEPROM */
-			EEPROM_readData(0x0311,savedPass,PASSWORD_SIZE);
-			savedPass[PASSWORD_SIZE] = '\0';
-			/* compare the received password and the saved password */
-			if(!strcmp((char*)enteredPass,(char*)savedPass)){
-				/* if the two passwords are the same send TRUE_PASSWORD byte to HMI_ECU */
-				UART_sendByte(TRUE_PASSWORD);
-				/* Receive an action byte from HMI_ECU (Open Door or Change Password) */
-				action = UART_recieveByte();
-				break;
-			}else{
-				/* if the two passwords are not the same send WRONG_PASSWORD byte to HMI_ECU */
-				UART_sendByte(WRONG_PASSWORD);
+		PROBE_BEGIN(PROBE_MAIN_LOOP);
+		/* count down the lockout every second, the commands are still served meanwhile */
+		while(RTC_isElapsed(second_start,1000)){
+			second_start += 1000;
+			if(Lockout_tickSecond()){
+				/* turn off buzzer at the end of the lockout */
+				Buzzer_off();
+				Trace_record(TRACE_EVENT_LOCKOUT_END,0);
 			}
 		}
 
-		/* if loop_counter variable reach 3, this means the user enters wrong password 3 times */
-		if(loop_counter == 3){
-			/* Set alarm flag */
-			alarm_flag = TRUE;
-			/* Set the Call back function pointer in the timer driver */
-			Timer_setCallBack(timerCallBack,TIMER1_ID);
-			/* Initialize the Timer driver :
-			 * use timer 1
-			 * prescaler 1024
-			 * compare mode
-			 * initial value = 0
-			 * compare value = 39062, so the interrupt occurs every 5 seconds
-			 */
-			Timer_init(&timerConfig);
-
-			/* turn on buzzer */
-			Buzzer_on();
-			/* wait until t_60s_flag become true, this will happen after 1 minute */
-			while(t_60s_flag != TRUE);
-			/* Reset the flags */
-			t_60s_flag = FALSE;
-			alarm_flag = FALSE;
-			/* turn off buzzer */
-			Buzzer_off();
-		}
-		/* if loop_counter variable doesn't reach 3, then the user enter the true password */
+		/* save the calendar time from time to time */
+		RTC_update();
+		PROBE_END(PROBE_MAIN_LOOP);
+
+		/* process the next command from HMI_ECU if any, checked with the interrupts disabled
+		 * so a byte received just before the sleep instruction still wakes the MCU */
+		SREG_REG.bits.I_bit = LOGIC_LOW;
+		if(UART_isByteReceived()){
+			SREG_REG.bits.I_bit = LOGIC_HIGH;
+			processCommand(UART_recieveByte());
+		}else{
+			/* nothing to do, sleep until the next 1 ms tick or the RX interrupt of the next byte */
+			Power_sleep(POWER_IDLE);
+		}
+	}
+}
+
+
+/*
+ * Description :
+ * Function responsible for processing one command byte from HMI_ECU, unknown bytes are ignored.
+ */
+void processCommand(uint8 command){
+	uint8 field;
+	uint16 value;
+	uint32 time;
+
+	Trace_record(TRACE_EVENT_COMMAND,command);
+	switch(command){
+	case SYSTEM_SETUP:
+		/* Ask for the admin password only when the system has none, a reset never replaces it */
+		if(Users_isActive(USERS_ADMIN_SLOT)){
+			UART_sendByte(SETUP_DONE);
+		}else{
+			UART_sendByte(SETUP_REQUIRED);
+			getAndSavePassword(USERS_ADMIN_SLOT);
+		}
+		break;
+	case LOGIN_REQUEST:
+		/* the user id and the keys of the PIN follow in secure link frames, then the result is sent */
+		if(beginLogin() && receivePin()){
+			finishLogin();
+		}
+		break;
+	case LOCKOUT_STATUS:
+		/* send the seconds left in the lockout, high byte first */
+		value = Lockout_remainingSeconds();
+		UART_sendByte((uint8)(value >> 8));
+		UART_sendByte((uint8)value);
+		break;
+	case HEARTBEAT:
+		UART_sendByte(HEARTBEAT_ACK);
+		break;
+	case BAUD_REQUEST:
+		/* HMI_ECU lost the link, it was reset or this ECU was, agree on the baud rate again */
+		negotiateBaudRate();
+		break;
+	case GET_TIME:
+		/* send the calendar time in seconds since 01/01/2000, high byte first */
+		time = RTC_getEpoch();
+		UART_sendByte((uint8)(time >> 24));
+		UART_sendByte((uint8)(time >> 16));
+		UART_sendByte((uint8)(time >> 8));
+		UART_sendByte((uint8)time);
+		break;
+	case CONFIG_READ:
+		/* send the value of the requested field, high byte first, 0 for an unknown field */
+		if(!UART_receiveByteTimeout(&field,COMMAND_BYTE_TIMEOUT_MS)){
+			field = 0;
+		}
+		value = Config_get((Config_FieldType)field);
+		UART_sendByte((uint8)(value >> 8));
+		UART_sendByte((uint8)value);
+		break;
+#ifdef DIAGNOSTICS_ENABLED
+	case AUDIT_DUMP:
+		/* stream the audit log for the host decoder */
+		Audit_dump();
+		break;
+	case TRACE_DUMP:
+		/* stream the trace of the last external inputs */
+		Trace_dump();
+		break;
+	case PROBE_DUMP:
+		/* send the execution time statistics of the probes */
+		Probe_dump();
+		break;
+#endif
+	case RAM_REPORT:
+		/* send the static RAM size, the stack headroom since reset and the RAM size, then the frame pool statistics */
+		StackMonitor_report();
+		FramePool_report();
+		break;
+	default:
+		/* line noise or a byte left from an interrupted exchange, it is not a command */
+		break;
+	}
+}
+
+/*
+ * Description :
+ * Function responsible for starting the login as soon as the user id is entered:
+ * 1. Refuse with ALARM_MODE while a lockout is active.
+ * 2. Receive the user slot, read its record and start the hash of the PIN while the user types it.
+ * Return FALSE if the login is refused.
+ */
+boolean beginLogin(void){
+	if(Lockout_isLocked()){
+		UART_sendByte(ALARM_MODE);
+		return FALSE;
+	}
+
+	/* Send CONTROL_ECU_READY byte to HMI_ECU to ask it to send the user slot */
+	UART_sendByte(CONTROL_ECU_READY);
+	/* Receive the user slot through the secure link, a rejected frame gives a login that always fails */
+	if(!receiveFrameByte(&g_loginSlot)){
+		g_loginSlot = LOCKOUT_NO_SLOT;
+	}
+	Users_beginVerify(g_loginSlot,&g_loginVerifier);
+	g_loginDigits = 0;
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Function responsible for receiving the PIN of the login, HMI_ECU sends a key frame of the same length
+ * for every key pressed, the enter key too, so the frames don't show the digits or the length of the PIN.
+ * The keys are taken like getPassword of HMI_ECU takes them, and every digit is added to the hash.
+ * Return TRUE when the enter key ends the PIN, or FALSE if a key frame is rejected or doesn't come:
+ * the login is dropped without counting an attempt and LOGIN_ABORTED is sent.
+ */
+boolean receivePin(void){
+	uint8 key;
+
+	for(;;){
+		if(!receiveFrameByte(&key)){
+			/* clear the verifier, the hash of the digits received so far doesn't stay in RAM */
+			Password_endVerify(&g_loginVerifier);
+			UART_sendByte(LOGIN_ABORTED);
+			return FALSE;
+		}
+		if((key == LOGIN_KEY_ENTER) && (g_loginDigits >= PASSWORD_MIN_SIZE)){
+			return TRUE;
+		}
+		if((key >= '0') && (key <= '9') && (g_loginDigits < PASSWORD_MAX_SIZE)){
+			Password_updateVerify(&g_loginVerifier,&key,1);
+			g_loginDigits++;
+		}
+	}
+}
+
+/*
+ * Description :
+ * Function responsible for the end of the login, when the user pressed '=':
+ * 1. Finish the hash of the PIN and compare it with the saved hash, a PIN of a wrong length is a wrong password.
+ * 2. True password out of the user schedule: send OUT_OF_SCHEDULE, it isn't counted as a wrong password.
+ * 3. True password: receive the action and process it.
+ * 4. Wrong password: count it, send ALARM_MODE if it started a lockout or WRONG_PASSWORD if not.
+ */
+void finishLogin(void){
+	uint8 action, slot = g_loginSlot;
+	boolean verified, allowed;
+	Audit_ResultType result;
+
+	/* the verifier is cleared even if the length is wrong */
+	PROBE_BEGIN(PROBE_PASSWORD_VERIFY);
+	verified = Password_endVerify(&g_loginVerifier)
+			&& (g_loginDigits >= PASSWORD_MIN_SIZE) && (g_loginDigits <= PASSWORD_MAX_SIZE);
+	PROBE_END(PROBE_PASSWORD_VERIFY);
+
+	/* the admin is never restricted, so a wrong schedule can't lock everybody out */
+	PROBE_BEGIN(PROBE_SCHEDULE_CHECK);
+	allowed = !verified || (slot == USERS_ADMIN_SLOT) || Schedule_isAllowed(slot,RTC_getEpoch());
+	PROBE_END(PROBE_SCHEDULE_CHECK);
+
+	if(!allowed){
+		Audit_append(RTC_getEpoch(),AUDIT_EVENT_OUT_OF_SCHEDULE,slot,AUDIT_RESULT_FAIL);
+		UART_sendByte(OUT_OF_SCHEDULE);
+	}else if(verified){
+		Lockout_registerSuccess(slot);
+		Audit_append(RTC_getEpoch(),AUDIT_EVENT_LOGIN,slot,AUDIT_RESULT_OK);
+		/* if the two passwords are the same send TRUE_PASSWORD byte to HMI_ECU */
+		UART_sendByte(TRUE_PASSWORD);
+		/* Receive an action byte from HMI_ECU (Open Door, Change Password, Enroll or Revoke user) */
+		if(!receiveFrameByte(&action)){
+			action = 0;
+		}
+
+		/* process Open Door option */
+		if(action == UNLOCK_DOOR){
+			Audit_append(RTC_getEpoch(),AUDIT_EVENT_DOOR_OPEN,slot,AUDIT_RESULT_OK);
+			openDoor();
+		}
+		/* process Change Password option */
+		else if(action == CHANGE_PASSWORD){
+			/* Get the new password of the logged in user from HMI_ECU and save it in the External EEPRPOM */
+			result = (getAndSavePassword(slot) == SUCCESS) ? AUDIT_RESULT_OK : AUDIT_RESULT_FAIL;
+			Audit_append(RTC_getEpoch(),AUDIT_EVENT_PASSWORD_CHANGE,slot,result);
+		}
+		/* process the admin options */
+		else if((action == ENROLL_USER) || (action == REVOKE_USER)){
+			manageUsers(action,slot);
+		}
+		else if(action == SET_TIME){
+			setTime(slot);
+		}
+		else if(action == SCHEDULE_EDIT){
+			editSchedule(slot);
+		}
+		else if(action == CONFIG_EDIT){
+			editConfig(slot);
+		}
+		/* a rejected action frame or an unknown action never moves the motor */
 		else{
-			/* process Open Door option */
-			if(action == UNLOCK_DOOR){
-				/* Set the call back function and initialize timer driver again  */
-				Timer_setCallBack(timerCallBack,TIMER1_ID);
-				Timer_init(&timerConfig);
-
-				/* Rotate the motor clockwise with maximum speed for 15 seconds */
-				DcMotor_Rotate(CW,100);
-				/* wait until t_15s_flag become true, this will happen after 15 seconds */
-				while(t_15s_flag != TRUE);
-				/* reset the flag */
-				t_15s_flag = FALSE;
-
-				/* stop the motor to keep the door open */
-				DcMotor_Rotate(CW,0);
-				/* wait until PIR sensor detect no motion (wait for all people to enter)*/
-				while(PIR_getState());
-
-				/* send LOCKING_DOOR byte to HMI_ECU */
-				UART_sendByte(LOCKING_DOOR);
-
-				/* Set the call back function and initialize timer driver again  */
-				Timer_setCallBack(timerCallBack,TIMER1_ID);
-				Timer_init(&timerConfig);
-
-				/* Rotate the motor anti-clockwise with maximum speed for 15 seconds */
-				DcMotor_Rotate(ACW,100);
-				/* wait until t_15s_flag become true, this will happen after 15 seconds */
-				while(t_15s_flag != TRUE);
-				/* reset the flag */
-				t_15s_flag = FALSE;
-				/* stop the motor */
-				DcMotor_Rotate(CW,0);
-			}
-			/* process Change Password option */
-			else if(action == CHANGE_PASSWORD){
+			UART_sendByte(ACCESS_DENIED);
+		}
+	}else{
+		Audit_append(RTC_getEpoch(),AUDIT_EVENT_LOGIN,slot,AUDIT_RESULT_FAIL);
+		if(Lockout_registerFailure(slot)){
+			Audit_append(RTC_getEpoch(),AUDIT_EVENT_LOCKOUT,slot,AUDIT_RESULT_OK);
+			/* turn on buzzer for the whole lockout and tell HMI_ECU to show it */
+			Buzzer_on();
+			UART_sendByte(ALARM_MODE);
+		}else{
+			/* if the two passwords are not the same send WRONG_PASSWORD byte to HMI_ECU */
+			UART_sendByte(WRONG_PASSWORD);
+		}
+	}
+	/* the records of one login usually fill one EEPROM page, write them together */
+	PROBE_BEGIN(PROBE_AUDIT_FLUSH);
+	Audit_flush();
+	PROBE_END(PROBE_AUDIT_FLUSH);
+}
 
-				/* Get the password from HMI_ECU and save it in the External EEPRPOM */
-				getAndSavePassword();
-				_delay_ms(10);
-			}
+/*
+ * Description :
+ * Function responsible for opening the door, waiting for the people to enter and locking it again.
+ * HMI_ECU follows the door with DOOR_UNLOCKED, LOCKING_DOOR and DOOR_LOCKED.
+ */
+void openDoor(void){
+	uint32 motion_time = Config_get(CONFIG_DOOR_SECONDS) * 1000UL;
+	uint8 speed = (uint8)Config_get(CONFIG_MOTOR_SPEED);
+	uint32 start;
+
+	/* Rotate the motor clockwise for the configured time */
+	rotateMotor(CW,speed);
+	start = RTC_getMilliseconds();
+	while(!RTC_isElapsed(start,motion_time)){
+		Power_sleep(POWER_IDLE);
+	}
+
+	/* stop the motor to keep the door open */
+	rotateMotor(CW,0);
+	UART_sendByte(DOOR_UNLOCKED);
+	/* wait until PIR sensor detect no motion (wait for all people to enter)*/
+	if(PIR_getState()){
+		Trace_record(TRACE_EVENT_PIR,LOGIC_HIGH);
+		while(PIR_getState()){
+			Power_sleep(POWER_IDLE);
 		}
+	}
+	Trace_record(TRACE_EVENT_PIR,LOGIC_LOW);
 
+	/* send LOCKING_DOOR byte to HMI_ECU */
+	UART_sendByte(LOCKING_DOOR);
+
+	/* Rotate the motor anti-clockwise for the configured time */
+	rotateMotor(ACW,speed);
+	start = RTC_getMilliseconds();
+	while(!RTC_isElapsed(start,motion_time)){
+		Power_sleep(POWER_IDLE);
 	}
+	/* stop the motor */
+	rotateMotor(CW,0);
+	UART_sendByte(DOOR_LOCKED);
 }
 
 
 /*
  * Description :
- * Function responsible for Get the password from HMI_ECU and save it in the External EEPRPOM.
+ * Function responsible for Get the password from HMI_ECU and save it in the user slot in the External EEPRPOM.
+ * It gives up with PASSWORD_NOT_SAVED when the EEPROM write fails or after PASSWORD_SAVE_ATTEMPTS pairs
+ * that are not the same, so rejected frames can't keep Control_ECU here. Return SUCCESS or ERROR.
  */
-void getAndSavePassword(void){
-	uint8 size = PASSWORD_SIZE+1;
-	uint8 pass1[size], pass2[size];
+uint8 getAndSavePassword(uint8 slot){
+	FramePool_FrameType * pass1, * pass2;
+	boolean same;
+	uint8 saved = ERROR;
+	uint8 attempt;
 	/* loop until the user enters same password twice for confimation  */
-	for(;;){
+	for(attempt = 1 ; ; attempt++){
 		/* Send CONTROL_ECU_READY byte to HMI_ECU to ask it to send the two passwords */
 		UART_sendByte(CONTROL_ECU_READY);
-		/* Receive the password and the confirmation password from HMI_ECU */
-		UART_receiveString(pass1);
-		UART_receiveString(pass2);
-
-		/* compare the two passwords */
-		if(!strcmp((char *)pass1,(char *)pass2)){
-			/* if the two passwords are the same save the password in the EEPROM */
-			EEPROM_writeData(0x0311,pass1,PASSWORD_SIZE);
+		/* Receive the password and the confirmation password from HMI_ECU through the secure link,
+		 * a rejected frame gives NULL_PTR */
+		pass1 = receiveFrame();
+		pass2 = receiveFrame();
+
+		/* compare the two passwords in constant time, the lengths aren't secret */
+		same = (pass1 != NULL_PTR) && (pass2 != NULL_PTR) && (pass1->length >= PASSWORD_MIN_SIZE)
+				&& (pass1->length <= PASSWORD_MAX_SIZE) && (pass1->length == pass2->length)
+				&& SecureCompare_equal(pass1->data,pass2->data,pass1->length);
+		if(same){
+			/* if the two passwords are the same save the salted hash of the password in the EEPROM */
+			saved = Users_enroll(slot,pass1->data,pass1->length);
+		}
+		FramePool_free(pass1);
+		FramePool_free(pass2);
+
+		if(same && (saved == SUCCESS)){
 			/* send PASSWORD_SAVED byte to HMI_ECU */
 			UART_sendByte(PASSWORD_SAVED);
-			return;
+			return SUCCESS;
+		}else if(same || (attempt >= PASSWORD_SAVE_ATTEMPTS)){
+			/* the EEPROM write failed or too many pairs were not the same */
+			UART_sendByte(PASSWORD_NOT_SAVED);
+			return ERROR;
 		}else{
 			/* if the two passwords are not the same, send DIFF_PASSWORDS byte to HMI_ECU */
 			UART_sendByte(DIFF_PASSWORDS);
@@ -227,22 +560,241 @@ void getAndSavePassword(void){
 
 /*
  * Description :
- * call-back function.
- */
-void timerCallBack(void){
-	tick++;
-	if((!alarm_flag) && (tick == 3)){
-		t_15s_flag = TRUE;
-		tick = 0;
-		Timer_deInit(TIMER1_ID);
-	}else if((alarm_flag) && (tick == 12)){
-		t_60s_flag = TRUE;
-		tick = 0;
-		Timer_deInit(TIMER1_ID);
+ * Function responsible for enrolling or revoking a user:
+ * 1. Only the admin (slot 0) is allowed, any other user gets ACCESS_DENIED.
+ * 2. Receive the target slot, the admin slot itself can't be enrolled or revoked here.
+ * 3. Enroll: get the new user password like the start up password. Revoke: clear the slot.
+ */
+void manageUsers(uint8 action, uint8 slot){
+	uint8 target;
+	Audit_ResultType result;
+
+	if(slot != USERS_ADMIN_SLOT){
+		Audit_append(RTC_getEpoch(),(action == ENROLL_USER) ? AUDIT_EVENT_USER_ENROLL : AUDIT_EVENT_USER_REVOKE,slot,AUDIT_RESULT_FAIL);
+		UART_sendByte(ACCESS_DENIED);
+		return;
+	}
+	UART_sendByte(ACCESS_GRANTED);
+
+	/* Receive the target user slot through the secure link */
+	if(!receiveFrameByte(&target) || (target == USERS_ADMIN_SLOT) || (target >= USERS_MAX_COUNT)){
+		UART_sendByte(USER_SLOT_INVALID);
+		return;
+	}
+	UART_sendByte(USER_SLOT_OK);
+
+	if(action == ENROLL_USER){
+		result = (getAndSavePassword(target) == SUCCESS) ? AUDIT_RESULT_OK : AUDIT_RESULT_FAIL;
+		Audit_append(RTC_getEpoch(),AUDIT_EVENT_USER_ENROLL,target,result);
+	}else{
+		Users_revoke(target);
+		/* wait for the EEPROM write cycle, the memory doesn't answer meanwhile */
+		_delay_ms(10);
+		/* a slot used again later starts without the old schedule */
+		Schedule_assign(target,SCHEDULE_NO_PROFILE);
+		Audit_append(RTC_getEpoch(),AUDIT_EVENT_USER_REVOKE,target,AUDIT_RESULT_OK);
+	}
+}
+
+/*
+ * Description :
+ * Function responsible for setting the calendar clock:
+ * 1. Only the admin (slot 0) is allowed, any other user gets ACCESS_DENIED.
+ * 2. Receive the date and time through the secure link and answer TIME_ACCEPTED or TIME_INVALID.
+ */
+void setTime(uint8 slot){
+	FramePool_FrameType * frame;
+	RTC_TimeType time;
+
+	if(slot != USERS_ADMIN_SLOT){
+		Audit_append(RTC_getEpoch(),AUDIT_EVENT_TIME_SET,slot,AUDIT_RESULT_FAIL);
+		UART_sendByte(ACCESS_DENIED);
+		return;
+	}
+	UART_sendByte(ACCESS_GRANTED);
+
+	frame = receiveFrame();
+	if((frame == NULL_PTR) || (frame->length != TIME_FRAME_SIZE)){
+		FramePool_free(frame);
+		UART_sendByte(TIME_INVALID);
+		return;
+	}
+	time.year = frame->data[0];
+	time.month = frame->data[1];
+	time.day = frame->data[2];
+	time.hours = frame->data[3];
+	time.minutes = frame->data[4];
+	time.seconds = frame->data[5];
+	FramePool_free(frame);
+
+	if(RTC_setTime(&time)){
+		/* the record holds the new time */
+		Audit_append(RTC_getEpoch(),AUDIT_EVENT_TIME_SET,slot,AUDIT_RESULT_OK);
+		UART_sendByte(TIME_ACCEPTED);
+	}else{
+		UART_sendByte(TIME_INVALID);
+	}
+}
+
+/*
+ * Description :
+ * Function responsible for editing the schedules:
+ * 1. Only the admin (slot 0) is allowed, any other user gets ACCESS_DENIED.
+ * 2. Receive the schedule frame through the secure link.
+ * 3. Compile a rule into its profile, clear a profile or assign a profile to a user slot,
+ *    then answer SCHEDULE_OK or SCHEDULE_INVALID.
+ *    A rule starting or ending inside a 30 minutes slot keeps only the complete slots.
+ */
+void editSchedule(uint8 slot){
+	FramePool_FrameType * frame;
+	uint8 * fields;
+	uint8 result = ERROR;
+	uint16 start, end;
+
+	if(slot != USERS_ADMIN_SLOT){
+		UART_sendByte(ACCESS_DENIED);
+		return;
+	}
+	UART_sendByte(ACCESS_GRANTED);
+
+	frame = receiveFrame();
+	if((frame != NULL_PTR) && (frame->length == SCHEDULE_FRAME_SIZE)){
+		fields = frame->data;
+		switch(fields[0]){
+		case SCHEDULE_OP_RULE:
+			if((fields[4] <= 24) && (fields[5] < 60) && (fields[6] <= 24) && (fields[7] < 60)){
+				start = ((uint16)fields[4] * 60) + fields[5];
+				end = ((uint16)fields[6] * 60) + fields[7];
+				result = Schedule_addRule(fields[1],fields[2],fields[3],
+						(uint8)((start + SCHEDULE_SLOT_MINUTES - 1) / SCHEDULE_SLOT_MINUTES),
+						(uint8)(end / SCHEDULE_SLOT_MINUTES));
+			}
+			break;
+		case SCHEDULE_OP_CLEAR:
+			result = Schedule_clearProfile(fields[1]);
+			break;
+		case SCHEDULE_OP_ASSIGN:
+			result = Schedule_assign(fields[1],fields[2]);
+			break;
+		}
+	}
+	FramePool_free(frame);
+
+	Audit_append(RTC_getEpoch(),AUDIT_EVENT_SCHEDULE_EDIT,slot,(result == SUCCESS) ? AUDIT_RESULT_OK : AUDIT_RESULT_FAIL);
+	UART_sendByte((result == SUCCESS) ? SCHEDULE_OK : SCHEDULE_INVALID);
+}
+
+/*
+ * Description :
+ * Function responsible for changing one field of the site configuration:
+ * 1. Only the admin (slot 0) is allowed, any other user gets ACCESS_DENIED.
+ * 2. Receive the field and its new value through the secure link.
+ * 3. Save it if it is in the field range and answer CONFIG_OK or CONFIG_INVALID.
+ */
+void editConfig(uint8 slot){
+	FramePool_FrameType * frame;
+	uint8 result = ERROR;
+
+	if(slot != USERS_ADMIN_SLOT){
+		UART_sendByte(ACCESS_DENIED);
+		return;
+	}
+	UART_sendByte(ACCESS_GRANTED);
+
+	frame = receiveFrame();
+	if((frame != NULL_PTR) && (frame->length == CONFIG_FRAME_SIZE)){
+		result = Config_set((Config_FieldType)frame->data[0],((uint16)frame->data[1] << 8) | frame->data[2]);
+	}
+	FramePool_free(frame);
+	Audit_append(RTC_getEpoch(),AUDIT_EVENT_CONFIG_EDIT,slot,(result == SUCCESS) ? AUDIT_RESULT_OK : AUDIT_RESULT_FAIL);
+	UART_sendByte((result == SUCCESS) ? CONFIG_OK : CONFIG_INVALID);
+}
+
+/*
+ * Description :
+ * Function responsible for negotiating the UART speed with HMI_ECU:
+ * 1. Propose each baud rate this ECU can generate within 2% error, from the configured fastest one.
+ * 2. HMI_ECU accepts the rate if it can generate it too, then both switch to it.
+ * 3. The last candidate is the base rate, so the negotiation always ends.
+ * The negotiation always starts from the base rate. If HMI_ECU doesn't answer BAUD_REQUEST_ATTEMPTS proposals,
+ * this ECU stays at the base rate, and HMI_ECU asks for a new negotiation with BAUD_REQUEST when it is ready.
+ */
+void negotiateBaudRate(void){
+	static const UART_BaudRateType rates[UART_NUM_OF_NEGOTIATION_RATES] PROGMEM = UART_NEGOTIATION_BAUD_RATES;
+	uint8 index, attempt, answer;
+	uint16 ubrr_value;
+	boolean u2x, answered;
+
+	UART_setBaudRate(UART_BASE_BAUD_RATE);
+	/* Give HMI_ECU time to switch to the base rate after its BAUD_REQUEST */
+	_delay_ms(1);
+
+	for(index = (uint8)Config_get(CONFIG_MAX_BAUD_INDEX) ; index < UART_NUM_OF_NEGOTIATION_RATES ; index++){
+		/* Skip the rates that can't be generated from this ECU clock */
+		if(!UART_calculateBaudRate(pgm_read_dword(&rates[index]),&ubrr_value,&u2x)){
+			continue;
+		}
+		for(attempt = 0 ; attempt < BAUD_REQUEST_ATTEMPTS ; attempt++){
+			/* Send BAUD_REQUEST followed by the index of the proposed rate */
+			UART_sendByte(BAUD_REQUEST);
+			UART_sendByte(index);
+
+			/* Bytes sent before the reset of one of the ECUs are skipped */
+			answered = FALSE;
+			while(!answered && UART_receiveByteTimeout(&answer,BAUD_ANSWER_TIMEOUT_MS)){
+				answered = (answer == BAUD_ACCEPTED) || (answer == BAUD_REJECTED);
+			}
+
+			if(answered && (answer == BAUD_ACCEPTED)){
+				UART_setBaudRate(pgm_read_dword(&rates[index]));
+				/* Give HMI_ECU time to switch before sending with the new rate */
+				_delay_ms(1);
+				return;
+			}
+			if(answered){
+				break;
+			}
+		}
+		/* No answer, HMI_ECU isn't listening : stay at the base rate */
+		if(attempt == BAUD_REQUEST_ATTEMPTS){
+			return;
+		}
 	}
 }
 
+/*
+ * Description :
+ * Function responsible for receiving a secure link frame from HMI_ECU into a pool frame and tracing its length.
+ * Return NULL_PTR if the frame is rejected, the caller gives the returned frame back with FramePool_free.
+ */
+FramePool_FrameType * receiveFrame(void){
+	FramePool_FrameType * frame = SecureLink_receiveFrame();
 
+	Trace_record(TRACE_EVENT_FRAME,(frame != NULL_PTR) ? frame->length : 0);
+	return frame;
+}
 
+/*
+ * Description :
+ * Function responsible for receiving a secure link frame of one byte from HMI_ECU.
+ * Return FALSE if the frame is rejected or isn't one byte long.
+ */
+boolean receiveFrameByte(uint8 * value){
+	FramePool_FrameType * frame = receiveFrame();
+	boolean received = (frame != NULL_PTR) && (frame->length == 1);
 
+	if(received){
+		*value = frame->data[0];
+	}
+	FramePool_free(frame);
+	return received;
+}
 
+/*
+ * Description :
+ * Function responsible for rotating the motor and tracing its new state, speed 0 stops it.
+ */
+void rotateMotor(DcMotor_State state, uint8 speed){
+	DcMotor_Rotate(state,speed);
+	Trace_record(TRACE_EVENT_MOTOR,(speed == 0) ? STOP : state);
+}
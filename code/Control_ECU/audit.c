@@ -0,0 +1,196 @@
+/*
+ ============================================================================
+ Name        : audit.c
+ Author      : Aziza Zamel
+ Description : Source file for the access audit log
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#include "audit.h"
+#include "external_eeprom.h"
+#include "uart.h"
+#include "util/delay.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define AUDIT_RECORDS_PER_PAGE	(AUDIT_PAGE_SIZE / AUDIT_RECORD_SIZE)
+
+/* Sequence numbers use 15 bits, so an erased record (0xFFFF) is never valid */
+#define AUDIT_SEQUENCE_MASK		0x7FFF
+
+/* Records read from the EEPROM at a time while dumping */
+#define AUDIT_DUMP_CHUNK		4
+
+#define AUDIT_RECORD_ADDRESS(INDEX)		(AUDIT_LOG_ADDRESS + ((uint16)(INDEX) * AUDIT_RECORD_SIZE))
+
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Index and sequence number of the next record */
+static uint8 g_head = 0;
+static uint16 g_nextSequence = 0;
+static uint8 g_count = 0;
+
+/* EEPROM page of the head record and the number of its records not written yet */
+static uint8 g_page[AUDIT_PAGE_SIZE];
+static uint8 g_pending = 0;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static boolean Audit_readSequence(uint8 index, uint16 * sequence);
+
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for finding the newest record by a binary search over the sequence numbers.
+ * Record i of the current lap holds the sequence of record 0 plus i, the records after the
+ * newest one are erased or belong to the previous lap, so the first mismatch ends the lap.
+ */
+void Audit_init(void){
+	uint16 first, sequence;
+	uint8 low, high, middle;
+
+	g_head = 0;
+	g_nextSequence = 0;
+	g_count = 0;
+	g_pending = 0;
+
+	if(Audit_readSequence(0, &first)){
+		/* low is always inside the current lap and high always after it */
+		low = 0;
+		high = AUDIT_MAX_RECORDS;
+		while((high - low) > 1){
+			middle = (low + high) / 2;
+			if(Audit_readSequence(middle, &sequence) && (sequence == ((first + middle) & AUDIT_SEQUENCE_MASK))){
+				low = middle;
+			}else{
+				high = middle;
+			}
+		}
+
+		g_head = (low + 1) % AUDIT_MAX_RECORDS;
+		g_nextSequence = (first + low + 1) & AUDIT_SEQUENCE_MASK;
+		/* the log is full if the record after the newest one is from the previous lap */
+		g_count = (Audit_readSequence(g_head, &sequence) || (low == AUDIT_MAX_RECORDS - 1)) ? AUDIT_MAX_RECORDS : (low + 1);
+	}
+
+	/* Load the page of the head, its older records are written again with the new ones */
+	EEPROM_readData(AUDIT_RECORD_ADDRESS(g_head - (g_head % AUDIT_RECORDS_PER_PAGE)), g_page, AUDIT_PAGE_SIZE);
+}
+
+/*
+ * Description :
+ * Function responsible for adding a record after the newest one, overwriting the oldest when the log is full.
+ * The record is kept in RAM until its EEPROM page is complete or Audit_flush is called.
+ */
+void Audit_append(uint32 time, Audit_EventType event, uint8 slot, Audit_ResultType result){
+	uint8 * record = &g_page[(g_head % AUDIT_RECORDS_PER_PAGE) * AUDIT_RECORD_SIZE];
+
+	record[0] = (uint8)(g_nextSequence >> 8);
+	record[1] = (uint8)g_nextSequence;
+	record[2] = (uint8)(time >> 24);
+	record[3] = (uint8)(time >> 16);
+	record[4] = (uint8)(time >> 8);
+	record[5] = (uint8)time;
+	record[6] = (uint8)((event << 4) | result);
+	record[7] = slot;
+
+	g_nextSequence = (g_nextSequence + 1) & AUDIT_SEQUENCE_MASK;
+	g_head = (g_head + 1) % AUDIT_MAX_RECORDS;
+	if(g_count < AUDIT_MAX_RECORDS){
+		g_count++;
+	}
+	g_pending++;
+
+	/* One EEPROM write cycle for the whole page */
+	if((g_head % AUDIT_RECORDS_PER_PAGE) == 0){
+		Audit_flush();
+	}
+}
+
+/*
+ * Description :
+ * Function responsible for writing the records waiting in RAM to the EEPROM.
+ * Only the waiting records are written, the rest of the page may still hold the oldest records.
+ */
+void Audit_flush(void){
+	uint8 end, start;
+
+	if(g_pending == 0){
+		return;
+	}
+
+	/* offset of the head in its page, a complete page ends at the page size */
+	end = g_head % AUDIT_RECORDS_PER_PAGE;
+	if(end == 0){
+		end = AUDIT_RECORDS_PER_PAGE;
+	}
+	start = end - g_pending;
+
+	EEPROM_writeData(AUDIT_RECORD_ADDRESS((g_head + AUDIT_MAX_RECORDS - g_pending) % AUDIT_MAX_RECORDS),
+			&g_page[start * AUDIT_RECORD_SIZE], g_pending * AUDIT_RECORD_SIZE);
+	/* wait for the EEPROM write cycle */
+	_delay_ms(10);
+	g_pending = 0;
+}
+
+/*
+ * Description :
+ * Function responsible for sending the number of records then all the records, oldest first, through UART.
+ * The records are read in chunks with sequential EEPROM reads, and sent without any processing.
+ */
+void Audit_dump(void){
+	uint8 chunk[AUDIT_DUMP_CHUNK * AUDIT_RECORD_SIZE];
+	uint8 index, remaining, records, i;
+
+	Audit_flush();
+
+	UART_sendByte(g_count);
+	index = (g_count == AUDIT_MAX_RECORDS) ? g_head : 0;
+	remaining = g_count;
+	while(remaining != 0){
+		/* a chunk stops at the end of the ring */
+		records = AUDIT_MAX_RECORDS - index;
+		if(records > AUDIT_DUMP_CHUNK){
+			records = AUDIT_DUMP_CHUNK;
+		}
+		if(records > remaining){
+			records = remaining;
+		}
+
+		EEPROM_readData(AUDIT_RECORD_ADDRESS(index), chunk, records * AUDIT_RECORD_SIZE);
+		for(i = 0 ; i < (records * AUDIT_RECORD_SIZE) ; i++){
+			UART_sendByte(chunk[i]);
+		}
+
+		index = (index + records) % AUDIT_MAX_RECORDS;
+		remaining -= records;
+	}
+}
+
+/*
+ * Description :
+ * Read the sequence number of a record, return FALSE if the record is erased or can't be read.
+ */
+static boolean Audit_readSequence(uint8 index, uint16 * sequence){
+	uint8 bytes[2];
+
+	if(EEPROM_readData(AUDIT_RECORD_ADDRESS(index), bytes, 2) != SUCCESS){
+		return FALSE;
+	}
+	*sequence = ((uint16)bytes[0] << 8) | bytes[1];
+	return (*sequence <= AUDIT_SEQUENCE_MASK) ? TRUE : FALSE;
+}
@@ -0,0 +1,80 @@
+/*
+ ============================================================================
+ Name        : audit.h
+ Author      : Aziza Zamel
+ Description : Header file for the access audit log
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef AUDIT_H_
+#define AUDIT_H_
+
+#include "std_types.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * The log is a ring of 8 bytes records in the free lower quarter of the 24C16 (0x0000 - 0x01FF).
+ * Record : sequence (2 bytes) | seconds since 01/01/2000 (4 bytes) | event << 4 | result | user slot
+ * Multi byte fields are big endian. The sequence is 15 bits, an erased record reads 0xFFFF.
+ */
+#define AUDIT_LOG_ADDRESS		0x0000
+#define AUDIT_RECORD_SIZE		8
+#define AUDIT_MAX_RECORDS		64
+
+/* Records are written to the EEPROM one page at a time */
+#define AUDIT_PAGE_SIZE			16
+
+/* Slot value for events that don't belong to a user */
+#define AUDIT_NO_SLOT			0xFF
+
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef enum{
+	AUDIT_EVENT_BOOT,AUDIT_EVENT_LOGIN,AUDIT_EVENT_DOOR_OPEN,AUDIT_EVENT_PASSWORD_CHANGE,
+	AUDIT_EVENT_USER_ENROLL,AUDIT_EVENT_USER_REVOKE,AUDIT_EVENT_LOCKOUT,AUDIT_EVENT_TIME_SET,
+	AUDIT_EVENT_OUT_OF_SCHEDULE,AUDIT_EVENT_SCHEDULE_EDIT,AUDIT_EVENT_CONFIG_EDIT
+}Audit_EventType;
+
+typedef enum{
+	AUDIT_RESULT_FAIL,AUDIT_RESULT_OK
+}Audit_ResultType;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for finding the newest record by a binary search over the sequence numbers.
+ */
+void Audit_init(void);
+
+/*
+ * Description :
+ * Function responsible for adding a record after the newest one, overwriting the oldest when the log is full.
+ * The record is kept in RAM until its EEPROM page is complete or Audit_flush is called.
+ */
+void Audit_append(uint32 time, Audit_EventType event, uint8 slot, Audit_ResultType result);
+
+/*
+ * Description :
+ * Function responsible for writing the records waiting in RAM to the EEPROM.
+ */
+void Audit_flush(void);
+
+/*
+ * Description :
+ * Function responsible for sending the number of records then all the records, oldest first, through UART.
+ */
+void Audit_dump(void);
+
+#endif /* AUDIT_H_ */
@@ -0,0 +1,243 @@
+/*
+ ============================================================================
+ Name        : config.c
+ Author      : Aziza Zamel
+ Description : Source file for the site configuration saved in EEPROM
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#include "config.h"
+#include "external_eeprom.h"
+#include "util/delay.h"
+#include "avr/pgmspace.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define CONFIG_HEADER_SIZE			2
+#define CONFIG_CRC_SIZE				2
+
+/* CRC-16/CCITT-FALSE */
+#define CONFIG_CRC_POLYNOMIAL		0x1021
+#define CONFIG_CRC_INITIAL			0xFFFF
+
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct{
+	uint16 min;
+	uint16 max;
+	uint16 initial;
+	uint8 size;			/* bytes in the record */
+}Config_FieldInfoType;
+
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Range, default and size of every field, in the order of the record */
+static const Config_FieldInfoType g_fieldsInfo[CONFIG_NUM_OF_FIELDS] PROGMEM = {
+	{5,60,15,1},		/* CONFIG_DOOR_SECONDS */
+	{10,100,100,1},		/* CONFIG_MOTOR_SPEED */
+	{1,10,3,1},			/* CONFIG_USER_ATTEMPTS */
+	{1,50,10,1},		/* CONFIG_GLOBAL_ATTEMPTS */
+	{10,600,60,2},		/* CONFIG_LOCKOUT_SECONDS, 600 s doubled 6 times still fits 16 bits */
+	{0,6,6,1},			/* CONFIG_LOCKOUT_MAX_LEVEL */
+	{0,5,0,1}			/* CONFIG_MAX_BAUD_INDEX */
+};
+
+static uint16 g_fields[CONFIG_NUM_OF_FIELDS];
+
+/* Version of the last record loaded */
+static uint8 g_loadedVersion = 0;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void Config_readInfo(uint8 index, Config_FieldInfoType * Info_Ptr);
+static uint16 Config_crc(const uint8 * data, uint8 length);
+static boolean Config_load(uint16 address);
+static boolean Config_isBackupIntact(void);
+static uint8 Config_save(void);
+
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for loading the configuration into RAM, from the first copy with a valid CRC.
+ * Missing or out of range fields take their defaults, and a damaged copy or a backup different from the primary is written again.
+ */
+void Config_init(void){
+	if(Config_load(CONFIG_PRIMARY_ADDRESS)){
+		/* migrate a record of an older version, or repair a backup damaged or left behind by a reset */
+		if((g_loadedVersion != CONFIG_VERSION) || !Config_isBackupIntact()){
+			Config_save();
+		}
+	}else{
+		/* the backup, or the defaults if it is damaged too, repair both copies */
+		Config_load(CONFIG_BACKUP_ADDRESS);
+		Config_save();
+	}
+}
+
+/*
+ * Description :
+ * Function responsible for returning the value of the field from RAM.
+ */
+uint16 Config_get(Config_FieldType field){
+	if((field < 1) || (field > CONFIG_NUM_OF_FIELDS)){
+		return 0;
+	}
+	return g_fields[field - 1];
+}
+
+/*
+ * Description :
+ * Function responsible for changing the field and saving the configuration.
+ * Return ERROR if the field doesn't exist, the value is out of its range or the EEPROM write fails.
+ */
+uint8 Config_set(Config_FieldType field, uint16 value){
+	Config_FieldInfoType info;
+
+	if((field < 1) || (field > CONFIG_NUM_OF_FIELDS)){
+		return ERROR;
+	}
+	Config_readInfo(field - 1, &info);
+	if((value < info.min) || (value > info.max)){
+		return ERROR;
+	}
+	if(g_fields[field - 1] == value){
+		return SUCCESS;
+	}
+	g_fields[field - 1] = value;
+	return Config_save();
+}
+
+/*
+ * Description :
+ * Copy the information of a field from flash.
+ */
+static void Config_readInfo(uint8 index, Config_FieldInfoType * Info_Ptr){
+	memcpy_P(Info_Ptr, &g_fieldsInfo[index], sizeof(Config_FieldInfoType));
+}
+
+/*
+ * Description :
+ * Calculate the CRC-16/CCITT of the data bit by bit, the record is too small to need a table.
+ */
+static uint16 Config_crc(const uint8 * data, uint8 length){
+	uint16 crc = CONFIG_CRC_INITIAL;
+	uint8 i, bit;
+
+	for(i = 0 ; i < length ; i++){
+		crc ^= (uint16)data[i] << 8;
+		for(bit = 0 ; bit < 8 ; bit++){
+			crc = (crc & 0x8000) ? ((crc << 1) ^ CONFIG_CRC_POLYNOMIAL) : (crc << 1);
+		}
+	}
+	return crc;
+}
+
+/*
+ * Description :
+ * Load the fields from the record at the address into RAM, return FALSE if the record is damaged.
+ * A record written by an older version has fewer fields, the new ones take their defaults,
+ * and a damaged record gives the defaults of all the fields. Out of range fields take their defaults too.
+ */
+static boolean Config_load(uint16 address){
+	uint8 record[CONFIG_RECORD_SIZE];
+	Config_FieldInfoType info;
+	uint8 size = 0, offset, i;
+	boolean valid = FALSE;
+
+	if(EEPROM_readData(address, record, CONFIG_RECORD_SIZE) == SUCCESS){
+		size = record[1];
+		if((record[0] != 0) && (size >= CONFIG_HEADER_SIZE) && (size <= (CONFIG_RECORD_SIZE - CONFIG_CRC_SIZE))
+				&& (Config_crc(record, size) == (((uint16)record[size] << 8) | record[size + 1]))){
+			valid = TRUE;
+			g_loadedVersion = record[0];
+		}
+	}
+
+	offset = CONFIG_HEADER_SIZE;
+	for(i = 0 ; i < CONFIG_NUM_OF_FIELDS ; i++){
+		Config_readInfo(i, &info);
+		g_fields[i] = info.initial;
+		if(valid && ((offset + info.size) <= size)){
+			g_fields[i] = (info.size == 2) ? (((uint16)record[offset] << 8) | record[offset + 1]) : record[offset];
+			if((g_fields[i] < info.min) || (g_fields[i] > info.max)){
+				g_fields[i] = info.initial;
+			}
+		}
+		offset += info.size;
+	}
+	return valid;
+}
+
+/*
+ * Description :
+ * Check that the backup copy is the same record as the valid primary copy, CRC included.
+ */
+static boolean Config_isBackupIntact(void){
+	uint8 primary[CONFIG_RECORD_SIZE];
+	uint8 backup[CONFIG_RECORD_SIZE];
+	uint8 i;
+
+	if((EEPROM_readData(CONFIG_PRIMARY_ADDRESS, primary, CONFIG_RECORD_SIZE) != SUCCESS)
+			|| (EEPROM_readData(CONFIG_BACKUP_ADDRESS, backup, CONFIG_RECORD_SIZE) != SUCCESS)){
+		return FALSE;
+	}
+	/* the primary copy was checked by Config_load, its size is in range */
+	for(i = 0 ; i < (primary[1] + CONFIG_CRC_SIZE) ; i++){
+		if(primary[i] != backup[i]){
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Save the fields in RAM into the primary copy then the backup copy, so one of them is always complete.
+ */
+static uint8 Config_save(void){
+	uint8 record[CONFIG_RECORD_SIZE];
+	Config_FieldInfoType info;
+	uint8 offset = CONFIG_HEADER_SIZE, i;
+	uint16 crc;
+
+	for(i = 0 ; i < CONFIG_NUM_OF_FIELDS ; i++){
+		Config_readInfo(i, &info);
+		if(info.size == 2){
+			record[offset++] = (uint8)(g_fields[i] >> 8);
+		}
+		record[offset++] = (uint8)g_fields[i];
+	}
+	record[0] = CONFIG_VERSION;
+	record[1] = offset;
+	crc = Config_crc(record, offset);
+	record[offset] = (uint8)(crc >> 8);
+	record[offset + 1] = (uint8)crc;
+
+	if(EEPROM_writeData(CONFIG_PRIMARY_ADDRESS, record, offset + CONFIG_CRC_SIZE) != SUCCESS){
+		return ERROR;
+	}
+	/* wait for the EEPROM write cycle */
+	_delay_ms(10);
+	if(EEPROM_writeData(CONFIG_BACKUP_ADDRESS, record, offset + CONFIG_CRC_SIZE) != SUCCESS){
+		return ERROR;
+	}
+	_delay_ms(10);
+	return SUCCESS;
+}
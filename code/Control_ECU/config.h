@@ -0,0 +1,74 @@
+/*
+ ============================================================================
+ Name        : config.h
+ Author      : Aziza Zamel
+ Description : Header file for the site configuration saved in EEPROM
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+#include "std_types.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * The configuration record is saved twice, one EEPROM page each, so a record damaged
+ * by a reset in the middle of a write can be restored from the other copy.
+ * Record : version | size | fields (1 or 2 bytes, big endian) | CRC-16 of version to the last field
+ */
+#define CONFIG_PRIMARY_ADDRESS		0x03C0
+#define CONFIG_BACKUP_ADDRESS		0x03D0
+#define CONFIG_RECORD_SIZE			16
+
+/* Increase it when a field is added at the end of the record, older records take the default of the new fields */
+#define CONFIG_VERSION				1
+
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* The field ids are used by the UART commands, never renumber them */
+typedef enum{
+	CONFIG_DOOR_SECONDS = 1,		/* time the motor needs to open or close the door */
+	CONFIG_MOTOR_SPEED,				/* duty cycle of the motor in percent */
+	CONFIG_USER_ATTEMPTS,			/* wrong passwords per user slot before a lockout */
+	CONFIG_GLOBAL_ATTEMPTS,			/* wrong passwords on all slots before a lockout */
+	CONFIG_LOCKOUT_SECONDS,			/* first lockout window, it doubles with every lockout in a row */
+	CONFIG_LOCKOUT_MAX_LEVEL,		/* number of times the lockout window can double */
+	CONFIG_MAX_BAUD_INDEX,			/* fastest UART rate proposed, index in UART_NEGOTIATION_BAUD_RATES */
+	CONFIG_NUM_OF_FIELDS = CONFIG_MAX_BAUD_INDEX
+}Config_FieldType;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for loading the configuration into RAM, from the first copy with a valid CRC.
+ * Missing or out of range fields take their defaults, and a damaged copy or a backup different from the primary is written again.
+ */
+void Config_init(void);
+
+/*
+ * Description :
+ * Function responsible for returning the value of the field from RAM.
+ */
+uint16 Config_get(Config_FieldType field);
+
+/*
+ * Description :
+ * Function responsible for changing the field and saving the configuration.
+ * Return ERROR if the field doesn't exist, the value is out of its range or the EEPROM write fails.
+ */
+uint8 Config_set(Config_FieldType field, uint16 value);
+
+#endif /* CONFIG_H_ */
@@ -12,28 +12,45 @@
 #include "external_eeprom.h"
 #include "twi.h"
 
+/*
+ * Every failed step sends the Stop Bit before returning ERROR, for example when the memory NACKs during
+ * its write cycle. Without it the next TWI_start would be a repeated start and every later transfer would fail.
+ */
+
 uint8 EEPROM_writeByte(uint16 u16addr, uint8 u8data)
 {
 	/* Send the Start Bit */
     TWI_start();
     if (TWI_getStatus() != TWI_START)
+    {
+        TWI_stop();
         return ERROR;
+    }
 		
     /* Send the device address, we need to get A8 A9 A10 address bits from the
      * memory location address and R/W=0 (write) */
     TWI_writeByte((uint8)(0xA0 | ((u16addr & 0x0700)>>7)));
     if (TWI_getStatus() != TWI_MT_SLA_W_ACK)
-        return ERROR; 
+    {
+        TWI_stop();
+        return ERROR;
+    }
 		 
     /* Send the required memory location address */
     TWI_writeByte((uint8)(u16addr));
     if (TWI_getStatus() != TWI_MT_DATA_ACK)
+    {
+        TWI_stop();
         return ERROR;
+    }
 		
     /* write byte to eeprom */
     TWI_writeByte(u8data);
     if (TWI_getStatus() != TWI_MT_DATA_ACK)
+    {
+        TWI_stop();
         return ERROR;
+    }
 
     /* Send the Stop Bit */
     TWI_stop();
@@ -46,34 +63,52 @@ uint8 EEPROM_readByte(uint16 u16addr, uint8 *u8data)
 	/* Send the Start Bit */
     TWI_start();
     if (TWI_getStatus() != TWI_START)
+    {
+        TWI_stop();
         return ERROR;
+    }
 		
     /* Send the device address, we need to get A8 A9 A10 address bits from the
      * memory location address and R/W=0 (write) */
     TWI_writeByte((uint8)((0xA0) | ((u16addr & 0x0700)>>7)));
     if (TWI_getStatus() != TWI_MT_SLA_W_ACK)
+    {
+        TWI_stop();
         return ERROR;
+    }
 		
     /* Send the required memory location address */
     TWI_writeByte((uint8)(u16addr));
     if (TWI_getStatus() != TWI_MT_DATA_ACK)
+    {
+        TWI_stop();
         return ERROR;
+    }
 		
     /* Send the Repeated Start Bit */
     TWI_start();
     if (TWI_getStatus() != TWI_REP_START)
+    {
+        TWI_stop();
         return ERROR;
+    }
 		
     /* Send the device address, we need to get A8 A9 A10 address bits from the
      * memory location address and R/W=1 (Read) */
     TWI_writeByte((uint8)((0xA0) | ((u16addr & 0x0700)>>7) | 1));
     if (TWI_getStatus() != TWI_MT_SLA_R_ACK)
+    {
+        TWI_stop();
         return ERROR;
+    }
 
     /* Read Byte from Memory without send ACK */
     *u8data = TWI_readByteWithNACK();
     if (TWI_getStatus() != TWI_MR_DATA_NACK)
+    {
+        TWI_stop();
         return ERROR;
+    }
 
     /* Send the Stop Bit */
     TWI_stop();
@@ -87,24 +122,36 @@ uint8 EEPROM_writeData(uint16 u16addr,uint8* u8data, uint8 size){
 	/* Send the Start Bit */
     TWI_start();
     if (TWI_getStatus() != TWI_START)
+    {
+        TWI_stop();
         return ERROR;
+    }
 
     /* Send the device address, we need to get A8 A9 A10 address bits from the
      * memory location address and R/W=0 (write) */
     TWI_writeByte((uint8)(0xA0 | ((u16addr & 0x0700)>>7)));
     if (TWI_getStatus() != TWI_MT_SLA_W_ACK)
+    {
+        TWI_stop();
         return ERROR;
+    }
 
     /* Send the required memory location address */
     TWI_writeByte((uint8)(u16addr));
     if (TWI_getStatus() != TWI_MT_DATA_ACK)
+    {
+        TWI_stop();
         return ERROR;
+    }
 
 	for (i = 0; i < size; i++) {
 	    /* write byte to eeprom */
 		TWI_writeByte(u8data[i]);
 		if (TWI_getStatus() != TWI_MT_DATA_ACK)
-			return ERROR;
+		{
+		    TWI_stop();
+		    return ERROR;
+		}
 	}
     /* Send the Stop Bit */
     TWI_stop();
@@ -117,40 +164,61 @@ uint8 EEPROM_readData(uint16 u16addr,uint8 *u8data, uint8 size){
 	/* Send the Start Bit */
     TWI_start();
     if (TWI_getStatus() != TWI_START)
+    {
+        TWI_stop();
         return ERROR;
+    }
 
     /* Send the device address, we need to get A8 A9 A10 address bits from the
      * memory location address and R/W=0 (write) */
     TWI_writeByte((uint8)((0xA0) | ((u16addr & 0x0700)>>7)));
     if (TWI_getStatus() != TWI_MT_SLA_W_ACK)
+    {
+        TWI_stop();
         return ERROR;
+    }
 
     /* Send the required memory location address */
     TWI_writeByte((uint8)(u16addr));
     if (TWI_getStatus() != TWI_MT_DATA_ACK)
+    {
+        TWI_stop();
         return ERROR;
+    }
 
     /* Send the Repeated Start Bit */
     TWI_start();
     if (TWI_getStatus() != TWI_REP_START)
+    {
+        TWI_stop();
         return ERROR;
+    }
 
     /* Send the device address, we need to get A8 A9 A10 address bits from the
      * memory location address and R/W=1 (Read) */
     TWI_writeByte((uint8)((0xA0) | ((u16addr & 0x0700)>>7) | 1));
     if (TWI_getStatus() != TWI_MT_SLA_R_ACK)
+    {
+        TWI_stop();
         return ERROR;
+    }
 
     for(i = 0 ; i<size-1 ; i++){
 		/* Read Byte from Memory and send ACK */
 		u8data[i] = TWI_readByteWithACK();
 		if (TWI_getStatus() != TWI_MR_DATA_ACK)
-			return ERROR;
+		{
+		    TWI_stop();
+		    return ERROR;
+		}
     }
     /* Read last Byte from Memory without send ACK */
     u8data[i] = TWI_readByteWithNACK();
     if (TWI_getStatus() != TWI_MR_DATA_NACK)
+    {
+        TWI_stop();
         return ERROR;
+    }
 
     /* Send the Stop Bit */
     TWI_stop();
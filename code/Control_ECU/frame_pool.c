@@ -0,0 +1,132 @@
+/*
+ ============================================================================
+ Name        : frame_pool.c
+ Author      : Aziza Zamel
+ Description : Source file for the pool of protocol frames
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#include "frame_pool.h"
+#include "uart.h"
+#include "ATmega32_Registers.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* End of the free list */
+#define FRAME_POOL_NO_FRAME			0xFF
+
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static FramePool_FrameType g_frames[FRAME_POOL_NUM_OF_FRAMES];
+
+/* Free frames are linked by their index, so taking and giving back a frame is O(1) */
+static uint8 g_nextFree[FRAME_POOL_NUM_OF_FRAMES];
+static uint8 g_firstFree = FRAME_POOL_NO_FRAME;
+
+static FramePool_StatsType g_stats;
+
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for putting all the frames in the free list and clearing the statistics.
+ */
+void FramePool_init(void){
+	uint8 interrupts = SREG_REG.bits.I_bit;
+	uint8 i;
+
+	SREG_REG.bits.I_bit = LOGIC_LOW;
+	for(i = 0 ; i < FRAME_POOL_NUM_OF_FRAMES ; i++){
+		g_nextFree[i] = i + 1;
+	}
+	g_nextFree[FRAME_POOL_NUM_OF_FRAMES - 1] = FRAME_POOL_NO_FRAME;
+	g_firstFree = 0;
+	g_stats.inUse = 0;
+	g_stats.peak = 0;
+	g_stats.failures = 0;
+	SREG_REG.bits.I_bit = interrupts;
+}
+
+/*
+ * Description :
+ * Function responsible for taking a frame from the pool, its length is 0.
+ * Return NULL_PTR if the pool is empty. It can be called from an interrupt.
+ */
+FramePool_FrameType * FramePool_alloc(void){
+	uint8 interrupts = SREG_REG.bits.I_bit;
+	FramePool_FrameType * Frame_Ptr = NULL_PTR;
+	uint8 index;
+
+	SREG_REG.bits.I_bit = LOGIC_LOW;
+	index = g_firstFree;
+	if(index != FRAME_POOL_NO_FRAME){
+		g_firstFree = g_nextFree[index];
+		Frame_Ptr = &g_frames[index];
+		Frame_Ptr->length = 0;
+		g_stats.inUse++;
+		if(g_stats.inUse > g_stats.peak){
+			g_stats.peak = g_stats.inUse;
+		}
+	}else if(g_stats.failures != 0xFFFF){
+		g_stats.failures++;
+	}
+	SREG_REG.bits.I_bit = interrupts;
+	return Frame_Ptr;
+}
+
+/*
+ * Description :
+ * Function responsible for giving the frame back to the pool, NULL_PTR is ignored.
+ * The owner of the frame must not use it after.
+ */
+void FramePool_free(FramePool_FrameType * Frame_Ptr){
+	uint8 interrupts = SREG_REG.bits.I_bit;
+	uint8 index;
+
+	if(Frame_Ptr == NULL_PTR){
+		return;
+	}
+	index = (uint8)(Frame_Ptr - g_frames);
+
+	SREG_REG.bits.I_bit = LOGIC_LOW;
+	g_nextFree[index] = g_firstFree;
+	g_firstFree = index;
+	g_stats.inUse--;
+	SREG_REG.bits.I_bit = interrupts;
+}
+
+/*
+ * Description :
+ * Function responsible for copying the statistics of the pool.
+ */
+void FramePool_getStats(FramePool_StatsType * Stats_Ptr){
+	uint8 interrupts = SREG_REG.bits.I_bit;
+
+	SREG_REG.bits.I_bit = LOGIC_LOW;
+	*Stats_Ptr = g_stats;
+	SREG_REG.bits.I_bit = interrupts;
+}
+
+/*
+ * Description :
+ * Function responsible for sending the statistics through UART : in use | peak | failures (2 bytes, big endian).
+ */
+void FramePool_report(void){
+	FramePool_StatsType stats;
+
+	FramePool_getStats(&stats);
+	UART_sendByte(stats.inUse);
+	UART_sendByte(stats.peak);
+	UART_sendByte((uint8)(stats.failures >> 8));
+	UART_sendByte((uint8)stats.failures);
+}
@@ -0,0 +1,86 @@
+/*
+ ============================================================================
+ Name        : frame_pool.h
+ Author      : Aziza Zamel
+ Description : Header file for the pool of protocol frames
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef FRAME_POOL_H_
+#define FRAME_POOL_H_
+
+#include "std_types.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Frames are fixed blocks taken from a static pool instead of the stack, so the RAM they use is known
+ * at link time. A frame is handed from the receiver to the application by its pointer, never copied.
+ */
+#define FRAME_POOL_NUM_OF_FRAMES	4
+#define FRAME_POOL_FRAME_SIZE		16
+
+/* Room before and after the data for the fields of the link (counter and tag), so a frame is received in place */
+#define FRAME_POOL_HEADER_SIZE		4
+#define FRAME_POOL_TRAILER_SIZE		4
+
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct{
+	uint8 length;
+	uint8 header[FRAME_POOL_HEADER_SIZE];
+	uint8 data[FRAME_POOL_FRAME_SIZE];
+	uint8 trailer[FRAME_POOL_TRAILER_SIZE];
+}FramePool_FrameType;
+
+typedef struct{
+	uint8 inUse;			/* frames allocated now */
+	uint8 peak;				/* most frames allocated at the same time since reset */
+	uint16 failures;		/* allocations refused because the pool was empty, it saturates */
+}FramePool_StatsType;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for putting all the frames in the free list and clearing the statistics.
+ */
+void FramePool_init(void);
+
+/*
+ * Description :
+ * Function responsible for taking a frame from the pool, its length is 0.
+ * Return NULL_PTR if the pool is empty. It can be called from an interrupt.
+ */
+FramePool_FrameType * FramePool_alloc(void);
+
+/*
+ * Description :
+ * Function responsible for giving the frame back to the pool, NULL_PTR is ignored.
+ * The owner of the frame must not use it after.
+ */
+void FramePool_free(FramePool_FrameType * Frame_Ptr);
+
+/*
+ * Description :
+ * Function responsible for copying the statistics of the pool.
+ */
+void FramePool_getStats(FramePool_StatsType * Stats_Ptr);
+
+/*
+ * Description :
+ * Function responsible for sending the statistics through UART : in use | peak | failures (2 bytes, big endian).
+ */
+void FramePool_report(void);
+
+#endif /* FRAME_POOL_H_ */
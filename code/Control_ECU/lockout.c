@@ -0,0 +1,220 @@
+/*
+ ============================================================================
+ Name        : lockout.c
+ Author      : Aziza Zamel
+ Description : Source file for the wrong password lockout policy
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#include "lockout.h"
+#include "users.h"
+#include "config.h"
+#include "external_eeprom.h"
+#include "util/delay.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define LOCKOUT_STATE_SIZE		4
+#define LOCKOUT_ERASED_BYTE		0xFF
+
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Consecutive wrong passwords on all slots and the value saved for it in EEPROM */
+static uint8 g_globalFailures = 0;
+static uint8 g_globalSaved = 0;
+
+/* Number of lockouts since the last correct password, it selects the lockout window */
+static uint8 g_level = 0;
+
+static uint16 g_remainingSeconds = 0;
+
+/* Consecutive wrong passwords of each user slot */
+static uint8 g_userFailures[USERS_MAX_COUNT];
+
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void Lockout_saveState(void);
+static void Lockout_saveUserFailures(uint8 slot, uint8 failures);
+
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for loading the failure counters from EEPROM.
+ * A lockout interrupted by a reset starts again with its full window.
+ */
+void Lockout_init(void){
+	uint8 state[LOCKOUT_STATE_SIZE];
+	uint8 slot;
+
+	if(EEPROM_readData(LOCKOUT_STATE_ADDRESS, state, LOCKOUT_STATE_SIZE) == SUCCESS){
+		g_globalFailures = (state[0] == LOCKOUT_ERASED_BYTE) ? 0 : state[0];
+		g_level = (state[1] == LOCKOUT_ERASED_BYTE) ? 0 : state[1];
+		/* the configuration may allow fewer levels since the state was saved */
+		if(g_level > Config_get(CONFIG_LOCKOUT_MAX_LEVEL)){
+			g_level = Config_get(CONFIG_LOCKOUT_MAX_LEVEL);
+		}
+		g_remainingSeconds = ((uint16)state[2] << 8) | state[3];
+		if(g_remainingSeconds == 0xFFFF){
+			g_remainingSeconds = 0;
+		}
+	}
+	g_globalSaved = g_globalFailures;
+
+	if(EEPROM_readData(LOCKOUT_USER_COUNTS_ADDRESS, g_userFailures, USERS_MAX_COUNT) != SUCCESS){
+		for(slot = 0 ; slot < USERS_MAX_COUNT ; slot++){
+			g_userFailures[slot] = 0;
+		}
+	}
+	for(slot = 0 ; slot < USERS_MAX_COUNT ; slot++){
+		if(g_userFailures[slot] == LOCKOUT_ERASED_BYTE){
+			g_userFailures[slot] = 0;
+		}
+	}
+}
+
+/*
+ * Description :
+ * Function responsible for counting down the active lockout, it must be called once every second.
+ * Return TRUE when the lockout has just ended.
+ */
+boolean Lockout_tickSecond(void){
+	if(g_remainingSeconds == 0){
+		return FALSE;
+	}
+	g_remainingSeconds--;
+	if(g_remainingSeconds == 0){
+		/* Save the end of the lockout, so a reset doesn't start it again */
+		Lockout_saveState();
+		return TRUE;
+	}
+	return FALSE;
+}
+
+/*
+ * Description :
+ * Function responsible for returning TRUE while a lockout is active.
+ */
+boolean Lockout_isLocked(void){
+	return (g_remainingSeconds != 0) ? TRUE : FALSE;
+}
+
+/*
+ * Description :
+ * Function responsible for returning the seconds left in the active lockout.
+ */
+uint16 Lockout_remainingSeconds(void){
+	return g_remainingSeconds;
+}
+
+/*
+ * Description :
+ * Function responsible for counting a wrong password for the slot.
+ * Return TRUE if this failure started a lockout.
+ */
+boolean Lockout_registerFailure(uint8 slot){
+	uint8 global_attempts = (uint8)Config_get(CONFIG_GLOBAL_ATTEMPTS);
+	uint8 user_attempts = (uint8)Config_get(CONFIG_USER_ATTEMPTS);
+	boolean lock = FALSE;
+
+	if(g_globalFailures < global_attempts){
+		g_globalFailures++;
+	}
+	if(g_globalFailures >= global_attempts){
+		lock = TRUE;
+	}
+
+	if(slot < USERS_MAX_COUNT){
+		/* On the first failure of a streak save the slot as if one attempt is left,
+		 * so the streak costs one EEPROM write and a reset doesn't give new attempts */
+		if(g_userFailures[slot] == 0){
+			Lockout_saveUserFailures(slot, user_attempts - 1);
+		}
+		g_userFailures[slot]++;
+		if(g_userFailures[slot] >= user_attempts){
+			lock = TRUE;
+		}
+	}
+
+	if(lock){
+		/* Exponential backoff: every lockout in a row doubles the window */
+		g_remainingSeconds = Config_get(CONFIG_LOCKOUT_SECONDS) << g_level;
+		if(g_level < Config_get(CONFIG_LOCKOUT_MAX_LEVEL)){
+			g_level++;
+		}
+		g_globalFailures = 0;
+		g_globalSaved = 0;
+		if(slot < USERS_MAX_COUNT){
+			g_userFailures[slot] = 0;
+			Lockout_saveUserFailures(slot, 0);
+		}
+		Lockout_saveState();
+		return TRUE;
+	}
+
+	/* Save the global counter ahead in batches instead of once per attempt */
+	if(g_globalFailures > g_globalSaved){
+		g_globalSaved = g_globalFailures + LOCKOUT_GLOBAL_RESERVE;
+		if(g_globalSaved > (global_attempts - 1)){
+			g_globalSaved = global_attempts - 1;
+		}
+		Lockout_saveState();
+	}
+	return FALSE;
+}
+
+/*
+ * Description :
+ * Function responsible for clearing the counters after a correct password for the slot.
+ */
+void Lockout_registerSuccess(uint8 slot){
+	if((slot < USERS_MAX_COUNT) && (g_userFailures[slot] != 0)){
+		g_userFailures[slot] = 0;
+		Lockout_saveUserFailures(slot, 0);
+	}
+	if((g_globalSaved != 0) || (g_level != 0)){
+		g_globalFailures = 0;
+		g_globalSaved = 0;
+		g_level = 0;
+		Lockout_saveState();
+	}
+}
+
+/*
+ * Description :
+ * Save the global counter, the level and the lockout window in one EEPROM page write.
+ */
+static void Lockout_saveState(void){
+	uint8 state[LOCKOUT_STATE_SIZE];
+
+	state[0] = g_globalSaved;
+	state[1] = g_level;
+	state[2] = (uint8)(g_remainingSeconds >> 8);
+	state[3] = (uint8)g_remainingSeconds;
+	EEPROM_writeData(LOCKOUT_STATE_ADDRESS, state, LOCKOUT_STATE_SIZE);
+	/* wait for the EEPROM write cycle */
+	_delay_ms(10);
+}
+
+/*
+ * Description :
+ * Save the failures counter of one user slot.
+ */
+static void Lockout_saveUserFailures(uint8 slot, uint8 failures){
+	EEPROM_writeByte(LOCKOUT_USER_COUNTS_ADDRESS + slot, failures);
+	/* wait for the EEPROM write cycle */
+	_delay_ms(10);
+}
@@ -0,0 +1,83 @@
+/*
+ ============================================================================
+ Name        : lockout.h
+ Author      : Aziza Zamel
+ Description : Header file for the wrong password lockout policy
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef LOCKOUT_H_
+#define LOCKOUT_H_
+
+#include "std_types.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * The attempts allowed per user slot and for all the slots together, the first lockout window
+ * and the number of times it can double are read from the site configuration (config.h).
+ */
+
+/* Global failures saved ahead in EEPROM, so a power cycle costs an attacker these attempts */
+#define LOCKOUT_GLOBAL_RESERVE		3
+
+/*
+ * EEPROM layout:
+ * state page  : global failures | level | lockout seconds (2 bytes, big endian)
+ * user counts : one byte per user slot
+ */
+#define LOCKOUT_STATE_ADDRESS		0x0300
+#define LOCKOUT_USER_COUNTS_ADDRESS	0x0340
+
+/* Slot value for failures that can't be charged to a valid user slot */
+#define LOCKOUT_NO_SLOT				0xFF
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for loading the failure counters from EEPROM.
+ * A lockout interrupted by a reset starts again with its full window.
+ */
+void Lockout_init(void);
+
+/*
+ * Description :
+ * Function responsible for counting down the active lockout, it must be called once every second.
+ * Return TRUE when the lockout has just ended.
+ */
+boolean Lockout_tickSecond(void);
+
+/*
+ * Description :
+ * Function responsible for returning TRUE while a lockout is active.
+ */
+boolean Lockout_isLocked(void);
+
+/*
+ * Description :
+ * Function responsible for returning the seconds left in the active lockout.
+ */
+uint16 Lockout_remainingSeconds(void);
+
+/*
+ * Description :
+ * Function responsible for counting a wrong password for the slot.
+ * Return TRUE if this failure started a lockout.
+ */
+boolean Lockout_registerFailure(uint8 slot);
+
+/*
+ * Description :
+ * Function responsible for clearing the counters after a correct password for the slot.
+ */
+void Lockout_registerSuccess(uint8 slot);
+
+#endif /* LOCKOUT_H_ */
@@ -0,0 +1,189 @@
+/*
+ ============================================================================
+ Name        : password.c
+ Author      : Aziza Zamel
+ Description : Source file for the salted password hashing and storage
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#include "password.h"
+#include "sha256.h"
+#include "secure_compare.h"
+#include "external_eeprom.h"
+#include "rtc.h"
+#include "ATmega32_Registers.h"
+#include "avr/eeprom.h"
+#include "util/delay.h"
+
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Secret of this unit kept in the internal EEPROM, mixed in every salt */
+static uint8 EEMEM g_unitSecretEeprom[PASSWORD_UNIT_SECRET_SIZE] = PASSWORD_DEFAULT_UNIT_SECRET;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void Password_stretch(SHA256_ContextType * Context_Ptr, const uint8 * salt, uint8 iterations, uint8 * hash);
+
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for hashing the password:
+ * digest = SHA256(salt | password), then (iterations - 1) times digest = SHA256(digest | salt).
+ */
+void Password_hash(const uint8 * password, uint8 length, const uint8 * salt, uint8 iterations, uint8 * hash){
+	SHA256_ContextType context;
+
+	SHA256_init(&context);
+	SHA256_update(&context, salt, PASSWORD_SALT_SIZE);
+	SHA256_update(&context, password, length);
+	Password_stretch(&context, salt, iterations, hash);
+}
+
+/*
+ * Description :
+ * Function responsible for saving the salted hash of the password in the record at the given EEPROM address.
+ * It returns after the EEPROM write cycle. Return SUCCESS or ERROR from the EEPROM driver.
+ */
+uint8 Password_save(uint16 address, const uint8 * password, uint8 length){
+	Password_RecordType record;
+	SHA256_ContextType context;
+	uint8 digest[SHA256_DIGEST_SIZE];
+	uint8 secret[PASSWORD_UNIT_SECRET_SIZE];
+	uint32 time[2];
+	uint8 tick;
+	uint8 i;
+
+	/*
+	 * New salt = SHA256(unit secret | record address | old record | calendar time | 1 ms tick | Timer2 counter).
+	 * The secret separates the units and the address the user slots, so the same PIN never gets the same salt,
+	 * the old record makes every salt of a slot different from the previous one even if the clock isn't set,
+	 * and the clock and the tick add whatever timing jitter is available. Timer2 always runs for the tick.
+	 */
+	eeprom_read_block(secret, g_unitSecretEeprom, PASSWORD_UNIT_SECRET_SIZE);
+	EEPROM_readData(address, (uint8 *)&record, sizeof(Password_RecordType));
+	time[0] = RTC_getEpoch();
+	time[1] = RTC_getMilliseconds();
+	tick = TCNT2_REG.byte;
+
+	SHA256_init(&context);
+	SHA256_update(&context, secret, PASSWORD_UNIT_SECRET_SIZE);
+	SHA256_update(&context, (const uint8 *)&address, sizeof(address));
+	SHA256_update(&context, (const uint8 *)&record, sizeof(Password_RecordType));
+	SHA256_update(&context, (const uint8 *)time, sizeof(time));
+	SHA256_update(&context, &tick, 1);
+	SHA256_final(&context, digest);
+	for(i = 0 ; i < PASSWORD_UNIT_SECRET_SIZE ; i++){
+		((volatile uint8 *)secret)[i] = 0;
+	}
+
+	for(i = 0 ; i < PASSWORD_SALT_SIZE ; i++){
+		record.salt[i] = digest[i];
+	}
+	record.status = PASSWORD_RECORD_VALID;
+	record.iterations = PASSWORD_HASH_ITERATIONS;
+	Password_hash(password, length, record.salt, record.iterations, record.hash);
+
+	if(EEPROM_writeData(address, (uint8 *)&record, sizeof(Password_RecordType)) != SUCCESS){
+		return ERROR;
+	}
+	/* wait for the EEPROM write cycle, so the caller can use the EEPROM right away */
+	_delay_ms(10);
+	return SUCCESS;
+}
+
+/*
+ * Description :
+ * Function responsible for checking the password against the hash saved at the given EEPROM address in constant time.
+ */
+boolean Password_verify(uint16 address, const uint8 * password, uint8 length){
+	Password_VerifierType verifier;
+
+	Password_beginVerify(&verifier, address);
+	Password_updateVerify(&verifier, password, length);
+	return Password_endVerify(&verifier);
+}
+
+/*
+ * Description :
+ * Function responsible for starting the check of a password whose digits arrive one by one:
+ * read the record at the given EEPROM address and start its hash with the salt.
+ */
+void Password_beginVerify(Password_VerifierType * Verifier_Ptr, uint16 address){
+	uint8 i;
+
+	Verifier_Ptr->valid = (address != PASSWORD_NO_ADDRESS)
+			&& (EEPROM_readData(address, (uint8 *)&Verifier_Ptr->record, sizeof(Password_RecordType)) == SUCCESS)
+			&& (Verifier_Ptr->record.status == PASSWORD_RECORD_VALID);
+
+	if(!Verifier_Ptr->valid){
+		/* the digits are still accepted, but there is nothing to compare them with */
+		for(i = 0 ; i < PASSWORD_SALT_SIZE ; i++){
+			Verifier_Ptr->record.salt[i] = 0;
+		}
+		Verifier_Ptr->record.iterations = 1;
+	}
+
+	SHA256_init(&Verifier_Ptr->context);
+	SHA256_update(&Verifier_Ptr->context, Verifier_Ptr->record.salt, PASSWORD_SALT_SIZE);
+}
+
+/*
+ * Description :
+ * Function responsible for adding the next digits of the password to its hash.
+ */
+void Password_updateVerify(Password_VerifierType * Verifier_Ptr, const uint8 * password, uint8 length){
+	SHA256_update(&Verifier_Ptr->context, password, length);
+}
+
+/*
+ * Description :
+ * Function responsible for finishing the hash and comparing it with the record in constant time.
+ * The verifier is cleared, so the hash of the password doesn't stay in RAM.
+ */
+boolean Password_endVerify(Password_VerifierType * Verifier_Ptr){
+	uint8 hash[PASSWORD_HASH_SIZE];
+	boolean equal;
+	uint16 i;
+
+	Password_stretch(&Verifier_Ptr->context, Verifier_Ptr->record.salt, Verifier_Ptr->record.iterations, hash);
+	equal = Verifier_Ptr->valid && SecureCompare_equal(hash, Verifier_Ptr->record.hash, PASSWORD_HASH_SIZE);
+
+	for(i = 0 ; i < sizeof(Password_VerifierType) ; i++){
+		((volatile uint8 *)Verifier_Ptr)[i] = 0;
+	}
+	return equal;
+}
+
+/*
+ * Description :
+ * Finish the hash of salt | password started in the context, hash it (iterations - 1) more times
+ * with the salt and keep the first PASSWORD_HASH_SIZE bytes.
+ */
+static void Password_stretch(SHA256_ContextType * Context_Ptr, const uint8 * salt, uint8 iterations, uint8 * hash){
+	uint8 digest[SHA256_DIGEST_SIZE];
+	uint8 i;
+
+	SHA256_final(Context_Ptr, digest);
+
+	for(i = 1 ; i < iterations ; i++){
+		SHA256_init(Context_Ptr);
+		SHA256_update(Context_Ptr, digest, SHA256_DIGEST_SIZE);
+		SHA256_update(Context_Ptr, salt, PASSWORD_SALT_SIZE);
+		SHA256_final(Context_Ptr, digest);
+	}
+
+	for(i = 0 ; i < PASSWORD_HASH_SIZE ; i++){
+		hash[i] = digest[i];
+	}
+}
@@ -0,0 +1,108 @@
+/*
+ ============================================================================
+ Name        : password.h
+ Author      : Aziza Zamel
+ Description : Header file for the salted password hashing and storage
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef PASSWORD_H_
+#define PASSWORD_H_
+
+#include "std_types.h"
+#include "sha256.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* The record fills exactly one 16 bytes page of the external EEPROM */
+#define PASSWORD_RECORD_SIZE		16
+#define PASSWORD_RECORD_VALID		0xA5
+
+#define PASSWORD_SALT_SIZE			4
+#define PASSWORD_HASH_SIZE			10
+
+/*
+ * Number of SHA-256 iterations for newly saved passwords.
+ * Each record keeps its own count, so changing it doesn't invalidate the saved password.
+ */
+#define PASSWORD_HASH_ITERATIONS	32
+
+/*
+ * Secret mixed in the salts, written to the internal EEPROM image (.eep file).
+ * Every unit must be programmed with its own random secret.
+ */
+#define PASSWORD_UNIT_SECRET_SIZE		8
+#define PASSWORD_DEFAULT_UNIT_SECRET	{0xC4,0x1B,0x7E,0x52,0x9A,0x36,0xE8,0x0D}
+
+/* Address given to Password_beginVerify for a user without a record, its verification always fails */
+#define PASSWORD_NO_ADDRESS			0xFFFF
+
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct{
+	uint8 status;
+	uint8 iterations;
+	uint8 salt[PASSWORD_SALT_SIZE];
+	uint8 hash[PASSWORD_HASH_SIZE];
+}Password_RecordType;
+
+/* State of a password checked while its digits arrive */
+typedef struct{
+	Password_RecordType record;
+	SHA256_ContextType context;
+	boolean valid;				/* the record was read and holds a password */
+}Password_VerifierType;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for hashing the password:
+ * digest = SHA256(salt | password), then (iterations - 1) times digest = SHA256(digest | salt).
+ */
+void Password_hash(const uint8 * password, uint8 length, const uint8 * salt, uint8 iterations, uint8 * hash);
+
+/*
+ * Description :
+ * Function responsible for saving the salted hash of the password in the record at the given EEPROM address.
+ * It returns after the EEPROM write cycle. Return SUCCESS or ERROR from the EEPROM driver.
+ */
+uint8 Password_save(uint16 address, const uint8 * password, uint8 length);
+
+/*
+ * Description :
+ * Function responsible for checking the password against the hash saved at the given EEPROM address in constant time.
+ */
+boolean Password_verify(uint16 address, const uint8 * password, uint8 length);
+
+/*
+ * Description :
+ * Function responsible for starting the check of a password whose digits arrive one by one:
+ * read the record at the given EEPROM address and start its hash with the salt.
+ */
+void Password_beginVerify(Password_VerifierType * Verifier_Ptr, uint16 address);
+
+/*
+ * Description :
+ * Function responsible for adding the next digits of the password to its hash.
+ */
+void Password_updateVerify(Password_VerifierType * Verifier_Ptr, const uint8 * password, uint8 length);
+
+/*
+ * Description :
+ * Function responsible for finishing the hash and comparing it with the record in constant time.
+ * The verifier is cleared, so the hash of the password doesn't stay in RAM.
+ */
+boolean Password_endVerify(Password_VerifierType * Verifier_Ptr);
+
+#endif /* PASSWORD_H_ */
@@ -0,0 +1,175 @@
+/*
+ ============================================================================
+ Name        : probe.c
+ Author      : Aziza Zamel
+ Description : Source file for the execution time probes
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#include "probe.h"
+#include "timer.h"
+#include "uart.h"
+#include "ATmega32_Registers.h"
+#include "timer_map.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* The probes read TCNT1 directly */
+#if (TIMER_MAP_PROBE != TIMER_MAP_TIMER1)
+#error "The execution time probes need Timer1"
+#endif
+
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct{
+	uint16 start;
+	uint16 min;
+	uint16 max;
+	uint32 count;
+	uint32 total;
+}Probe_StatsType;
+
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+#ifdef PROBE_ENABLED
+/* The RTC_TICK and FRAME_BYTE entries are updated from interrupts, copy the entries with interrupts disabled */
+static volatile Probe_StatsType g_probes[PROBE_NUM_OF_PROBES];
+#endif
+
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+#ifdef PROBE_ENABLED
+static uint16 Probe_readTimer(void);
+static void Probe_sendValue(uint32 value, uint8 size);
+#endif
+
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for starting Timer1 as a free running counter and clearing the table.
+ */
+void Probe_init(void){
+#ifdef PROBE_ENABLED
+	/* Create configuration structure for the probe counter :
+	 * use timer 1
+	 * prescaler 8
+	 * overflow mode, the overflow interrupt has no call back
+	 * initial value = 0
+	 */
+	Timer_ConfigType probeConfig = {0,0,TIMER1_ID,PROBE_TIMER_CLOCK,OVERFLOW_MODE};
+	uint8 id;
+
+	for(id = 0 ; id < PROBE_NUM_OF_PROBES ; id++){
+		g_probes[id].min = 0xFFFF;
+		g_probes[id].max = 0;
+		g_probes[id].count = 0;
+		g_probes[id].total = 0;
+	}
+	if(Timer_claim(TIMER1_ID,TIMER_USER_PROBE)){
+		Timer_init(&probeConfig,TIMER_USER_PROBE);
+	}
+#endif
+}
+
+#ifdef PROBE_ENABLED
+/*
+ * Description :
+ * Function responsible for saving the start time of the probe span, use PROBE_BEGIN.
+ */
+void Probe_begin(Probe_IdType id){
+	g_probes[id].start = Probe_readTimer();
+}
+
+/*
+ * Description :
+ * Function responsible for adding the span since Probe_begin to the probe statistics, use PROBE_END.
+ * When the total would overflow, the total and the count are halved, which keeps the average.
+ */
+void Probe_end(Probe_IdType id){
+	uint16 span = Probe_readTimer() - g_probes[id].start;
+
+	if(span < g_probes[id].min){
+		g_probes[id].min = span;
+	}
+	if(span > g_probes[id].max){
+		g_probes[id].max = span;
+	}
+	if((g_probes[id].total + span) < g_probes[id].total){
+		g_probes[id].total >>= 1;
+		g_probes[id].count >>= 1;
+	}
+	g_probes[id].total += span;
+	g_probes[id].count++;
+}
+#endif
+
+/*
+ * Description :
+ * Function responsible for sending the number of probes then the statistics of every probe.
+ */
+void Probe_dump(void){
+#ifdef PROBE_ENABLED
+	Probe_StatsType probe;
+	uint8 id, interrupts;
+
+	UART_sendByte(PROBE_NUM_OF_PROBES);
+	for(id = 0 ; id < PROBE_NUM_OF_PROBES ; id++){
+		interrupts = SREG_REG.bits.I_bit;
+		SREG_REG.bits.I_bit = LOGIC_LOW;
+		probe = g_probes[id];
+		SREG_REG.bits.I_bit = interrupts;
+
+		Probe_sendValue(probe.count, 4);
+		Probe_sendValue((probe.count == 0) ? 0 : probe.min, 2);
+		Probe_sendValue(probe.max, 2);
+		Probe_sendValue((probe.count == 0) ? 0 : (probe.total / probe.count), 2);
+	}
+#else
+	UART_sendByte(0);
+#endif
+}
+
+#ifdef PROBE_ENABLED
+/*
+ * Description :
+ * Read the 16 bits counter of Timer1. Its high byte is latched by the first read,
+ * so the interrupts are disabled to keep a probe in an interrupt from changing it meanwhile.
+ */
+static uint16 Probe_readTimer(void){
+	uint16 ticks;
+	uint8 interrupts = SREG_REG.bits.I_bit;
+
+	SREG_REG.bits.I_bit = LOGIC_LOW;
+	ticks = TCNT1_REG.TwoBytes;
+	SREG_REG.bits.I_bit = interrupts;
+	return ticks;
+}
+
+/*
+ * Description :
+ * Send the value through UART, high byte first.
+ */
+static void Probe_sendValue(uint32 value, uint8 size){
+	while(size != 0){
+		size--;
+		UART_sendByte((uint8)(value >> (8 * size)));
+	}
+}
+#endif
@@ -0,0 +1,86 @@
+/*
+ ============================================================================
+ Name        : probe.h
+ Author      : Aziza Zamel
+ Description : Header file for the execution time probes
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef PROBE_H_
+#define PROBE_H_
+
+#include "std_types.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Uncomment to measure the probes, without it PROBE_BEGIN and PROBE_END compile to nothing and Timer1 stays free */
+//#define PROBE_ENABLED
+
+/*
+ * The probes read Timer1 running at F_CPU / 8, one tick is 1 us at 8 MHz.
+ * A span longer than 65535 ticks is measured modulo 65536.
+ */
+#define PROBE_TIMER_CLOCK		F_CPU_8
+
+#ifdef PROBE_ENABLED
+#define PROBE_BEGIN(ID)			Probe_begin(ID)
+#define PROBE_END(ID)			Probe_end(ID)
+#else
+#define PROBE_BEGIN(ID)
+#define PROBE_END(ID)
+#endif
+
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* The probe ids are used by the UART diagnostics command, only add new ones at the end */
+typedef enum{
+	PROBE_RTC_TICK,				/* Timer2 1 ms tick interrupt */
+	PROBE_MAIN_LOOP,			/* main loop pass without a command */
+	PROBE_PASSWORD_VERIFY,		/* salted hash of a login password and its EEPROM record read */
+	PROBE_SCHEDULE_CHECK,		/* schedule decision of a login */
+	PROBE_AUDIT_FLUSH,			/* audit records written to the EEPROM after a login */
+	PROBE_FRAME_BYTE,			/* secure link frame byte written in place from the RX interrupt */
+	PROBE_NUM_OF_PROBES
+}Probe_IdType;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for starting Timer1 as a free running counter and clearing the table.
+ * It does nothing if PROBE_ENABLED is not defined.
+ */
+void Probe_init(void);
+
+#ifdef PROBE_ENABLED
+/*
+ * Description :
+ * Function responsible for saving the start time of the probe span, use PROBE_BEGIN.
+ */
+void Probe_begin(Probe_IdType id);
+
+/*
+ * Description :
+ * Function responsible for adding the span since Probe_begin to the probe statistics, use PROBE_END.
+ */
+void Probe_end(Probe_IdType id);
+#endif
+
+/*
+ * Description :
+ * Function responsible for sending the number of probes (0 if PROBE_ENABLED is not defined),
+ * then count (4 bytes), min, max and average (2 bytes each) of every probe in Timer1 ticks, big endian.
+ */
+void Probe_dump(void);
+
+#endif /* PROBE_H_ */
@@ -9,6 +9,42 @@
 #include "pwm.h"
 #include "ATmega32_Registers.h"
 #include "gpio.h"
+#include "avr/pgmspace.h"
+#include "timer.h"
+#include "timer_map.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#if (TIMER_MAP_PWM != TIMER_MAP_TIMER0)
+#error "The PWM driver needs Timer0"
+#endif
+
+/* Compare output modes of OC0 (COM01:0) */
+#define PWM_OC0_DISCONNECTED		0
+#define PWM_OC0_NON_INVERTED		2
+
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Compare value of each duty cycle percent, rounded (percent * 255 / 100), so no floating point is needed */
+static const uint8 g_percentToCompare[PWM_MAX_PERCENT + 1] PROGMEM = {
+	0,3,5,8,10,13,15,18,20,23,
+	26,28,31,33,36,38,41,43,46,48,
+	51,54,56,59,61,64,66,69,71,74,
+	77,79,82,84,87,89,92,94,97,99,
+	102,105,107,110,112,115,117,120,122,125,
+	128,130,133,135,138,140,143,145,148,150,
+	153,156,158,161,163,166,168,171,173,176,
+	179,181,184,186,189,191,194,196,199,201,
+	204,207,209,212,214,217,219,222,224,227,
+	230,232,235,237,240,242,245,247,250,252,
+	255
+};
 
 
 /*******************************************************************************
@@ -18,19 +54,40 @@
 /*
  * Description :
  * Function responsible for Initialize Timer0 in PWM mode and sets the required duty cycle.
+ * Timer0 is left untouched if another driver owns it.
  */
 void PWM_Timer0_Start(uint8 duty_cycle){
-	TCNT0_REG.byte = 0;											/* Set Timer Initial Value to 0 */
+	if(!Timer_claim(TIMER0_ID,TIMER_USER_PWM)){
+		return;
+	}
+	if(duty_cycle > PWM_MAX_PERCENT){
+		duty_cycle = PWM_MAX_PERCENT;
+	}
 
-	OCR0_REG.byte = (uint8)(duty_cycle/100.0 *TIMER0_MAX_COMPARE_VALUE);	/* Set Compare value */
+	TCNT0_REG.byte = 0;											/* Set Timer Initial Value to 0 */
 
 	GPIO_setupPinDirection(PORTB_ID,PIN3_ID,PIN_OUTPUT);
 
 	TCCR0_REG.bits.FOC0_bit = LOGIC_LOW;				/* Fast PWM mode FOC0=0 */
 	TCCR0_REG.bits.WGM00_bit = LOGIC_HIGH;				/* Fast PWM Mode WGM01=1 & WGM00=1 */
 	TCCR0_REG.bits.WGM01_bit = LOGIC_HIGH;
-	TCCR0_REG.bits.COM0_bits = 2;                       /* Clear OC0 when match occurs (non inverted mode) COM01=1 & COM00=0 */
+	PWM_Timer0_SetDuty(pgm_read_byte(&g_percentToCompare[duty_cycle]));	/* Set Compare value and connect OC0 unless the duty cycle is 0 */
 	TCCR0_REG.bits.CS0_bits = TIMER0_CLOCK_SOURCE;		/* Select the clock source */
 
 }
 
+/*
+ * Description :
+ * Function responsible for changing the duty cycle of the running PWM, in 1/256 steps (0 = off, 255 = always on).
+ * Fast PWM sets OC0 at BOTTOM even with a compare value of 0, which gives a pulse of one timer clock every period,
+ * so 0 disconnects OC0 and drives its pin low instead. Only a few registers are written, so it is cheap enough for a control loop.
+ */
+void PWM_Timer0_SetDuty(uint8 duty){
+	OCR0_REG.byte = duty;
+	if(duty == 0){
+		TCCR0_REG.bits.COM0_bits = PWM_OC0_DISCONNECTED;	/* Normal port operation, OC0 disconnected */
+		GPIO_writePin(PORTB_ID,PIN3_ID,LOGIC_LOW);
+	}else{
+		TCCR0_REG.bits.COM0_bits = PWM_OC0_NON_INVERTED;	/* Clear OC0 when match occurs (non inverted mode) COM01=1 & COM00=0 */
+	}
+}
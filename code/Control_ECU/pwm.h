@@ -27,6 +27,9 @@
 #define TIMER0_CLOCK_SOURCE			TIMER0_PRESCALER_64
 #define TIMER0_MAX_COMPARE_VALUE	255
 
+/* Duty cycles are given in percent (0 - 100), or in 1/256 steps for PWM_Timer0_SetDuty */
+#define PWM_MAX_PERCENT				100
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
@@ -34,7 +37,15 @@
 /*
  * Description :
  * Function responsible for Initialize Timer0 in PWM mode and sets the required duty cycle.
+ * Timer0 is left untouched if another driver owns it.
  */
 void PWM_Timer0_Start(uint8 duty_cycle);
 
+/*
+ * Description :
+ * Function responsible for changing the duty cycle of the running PWM, in 1/256 steps (255 = always on).
+ * A duty cycle of 0 disconnects OC0 and keeps its pin low.
+ */
+void PWM_Timer0_SetDuty(uint8 duty);
+
 #endif /* PWM_H_ */
@@ -0,0 +1,287 @@
+/*
+ ============================================================================
+ Name        : rtc.c
+ Author      : Aziza Zamel
+ Description : Source file for the system tick and the calendar clock
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#include "rtc.h"
+#include "timer.h"
+#include "ATmega32_Registers.h"
+#include "avr/eeprom.h"
+#include "avr/pgmspace.h"
+#include "probe.h"
+#include "timer_map.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* The tick prescaler and compare value are those of Timer2 */
+#if (TIMER_MAP_TICK != TIMER_MAP_TIMER2)
+#error "The RTC tick needs Timer2"
+#endif
+
+#define RTC_SECONDS_PER_DAY		86400UL
+
+/* 01/01/2000 was a Saturday */
+#define RTC_BASE_WEEKDAY		RTC_SATURDAY
+
+/* Value read from an erased EEPROM location */
+#define RTC_ERASED_EPOCH		0xFFFFFFFFUL
+
+#define RTC_IS_LEAP_YEAR(YEAR)	(((YEAR) & 3) == 0)
+
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* State of the 1 ms tick, it is the context of the tick call back */
+typedef struct{
+	uint32 milliseconds;
+	uint32 epoch;
+	uint16 subSecond;			/* milliseconds since the last second */
+}RTC_ClockType;
+
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Updated by the 1 ms tick, read it with interrupts disabled */
+static volatile RTC_ClockType g_clock = {0,0,0};
+
+static uint32 g_savedEpoch = 0;
+static boolean g_isSet = FALSE;
+
+static uint32 EEMEM g_epochEeprom = RTC_ERASED_EPOCH;
+
+static const uint8 g_daysInMonth[12] PROGMEM = {31,28,31,30,31,30,31,31,30,31,30,31};
+
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void RTC_tickCallBack(void * context);
+static uint32 RTC_readAtomic(volatile uint32 * value);
+static uint8 RTC_daysInMonth(uint8 month, uint8 year);
+static void RTC_save(uint32 epoch);
+
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for starting the 1 ms tick on Timer2 and loading the last saved calendar time.
+ * The clock stays not set until RTC_setTime, the saved time is only a lower bound of the real time.
+ */
+void RTC_init(void){
+	/* Create configuration structure for the 1 ms tick :
+	 * use timer 2
+	 * prescaler 64
+	 * compare mode
+	 * initial value = 0
+	 * compare value = 124, so the interrupt occurs every 1 ms
+	 */
+	Timer_ConfigType tickConfig = {0,124,TIMER2_ID,F_TIMER2_CPU_64,COMPARE_MODE};
+
+	/*
+	 * The saved time is behind by up to RTC_SAVE_PERIOD_SECONDS plus the time the unit was off,
+	 * it only keeps the audit records in order. A power cut must not move a restricted user
+	 * back into an allowed time slot, so the clock isn't trusted until the admin sets it.
+	 */
+	eeprom_read_block(&g_savedEpoch, &g_epochEeprom, sizeof(uint32));
+	if(g_savedEpoch == RTC_ERASED_EPOCH){
+		g_savedEpoch = 0;
+	}
+	g_clock.epoch = g_savedEpoch;
+
+	if(Timer_claim(TIMER2_ID,TIMER_USER_TICK)){
+		Timer_subscribe(TIMER2_ID,RTC_tickCallBack,(void *)&g_clock);
+		Timer_init(&tickConfig,TIMER_USER_TICK);
+	}
+}
+
+/*
+ * Description :
+ * Function responsible for saving the calendar time every RTC_SAVE_PERIOD_SECONDS, call it from the main loop.
+ * The EEPROM is not written from the interrupt, its write cycle is too long.
+ */
+void RTC_update(void){
+	uint32 epoch = RTC_getEpoch();
+
+	if(g_isSet && ((epoch - g_savedEpoch) >= RTC_SAVE_PERIOD_SECONDS)){
+		RTC_save(epoch);
+	}
+}
+
+/*
+ * Description :
+ * Function responsible for returning the milliseconds since start up, it rolls over after 49 days.
+ */
+uint32 RTC_getMilliseconds(void){
+	return RTC_readAtomic(&g_clock.milliseconds);
+}
+
+/*
+ * Description :
+ * Function responsible for checking if the duration passed since start, it works across the rollover.
+ */
+boolean RTC_isElapsed(uint32 start, uint32 duration){
+	return ((RTC_getMilliseconds() - start) >= duration) ? TRUE : FALSE;
+}
+
+/*
+ * Description :
+ * Function responsible for returning the calendar time in seconds since 01/01/2000.
+ */
+uint32 RTC_getEpoch(void){
+	return RTC_readAtomic(&g_clock.epoch);
+}
+
+/*
+ * Description :
+ * Function responsible for returning TRUE if the calendar time was set since the last reset.
+ */
+boolean RTC_isSet(void){
+	return g_isSet;
+}
+
+/*
+ * Description :
+ * Function responsible for setting the calendar time and saving it.
+ * Return FALSE if the time is not a valid date between 2000 and 2099.
+ */
+boolean RTC_setTime(const RTC_TimeType * Time_Ptr){
+	uint32 epoch;
+	uint16 days = 0;
+	uint8 i, interrupts;
+
+	if((Time_Ptr->year > RTC_MAX_YEAR) || (Time_Ptr->month < 1) || (Time_Ptr->month > 12)
+			|| (Time_Ptr->day < 1) || (Time_Ptr->day > RTC_daysInMonth(Time_Ptr->month,Time_Ptr->year))
+			|| (Time_Ptr->hours > 23) || (Time_Ptr->minutes > 59) || (Time_Ptr->seconds > 59)){
+		return FALSE;
+	}
+
+	for(i = 0 ; i < Time_Ptr->year ; i++){
+		days += RTC_IS_LEAP_YEAR(i) ? 366 : 365;
+	}
+	for(i = 1 ; i < Time_Ptr->month ; i++){
+		days += RTC_daysInMonth(i,Time_Ptr->year);
+	}
+	days += Time_Ptr->day - 1;
+	epoch = (days * RTC_SECONDS_PER_DAY) + (Time_Ptr->hours * 3600UL) + (Time_Ptr->minutes * 60U) + Time_Ptr->seconds;
+
+	/* Restart the second with the new time */
+	interrupts = SREG_REG.bits.I_bit;
+	SREG_REG.bits.I_bit = LOGIC_LOW;
+	g_clock.epoch = epoch;
+	g_clock.subSecond = 0;
+	SREG_REG.bits.I_bit = interrupts;
+
+	g_isSet = TRUE;
+	RTC_save(epoch);
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Function responsible for reading the calendar time.
+ */
+void RTC_getTime(RTC_TimeType * Time_Ptr){
+	RTC_epochToTime(RTC_getEpoch(),Time_Ptr);
+}
+
+/*
+ * Description :
+ * Function responsible for converting seconds since 01/01/2000 to date and time.
+ */
+void RTC_epochToTime(uint32 epoch, RTC_TimeType * Time_Ptr){
+	uint16 days = (uint16)(epoch / RTC_SECONDS_PER_DAY);
+	uint32 seconds = epoch % RTC_SECONDS_PER_DAY;
+	uint16 length;
+
+	Time_Ptr->hours = (uint8)(seconds / 3600);
+	Time_Ptr->minutes = (uint8)((seconds / 60) % 60);
+	Time_Ptr->seconds = (uint8)(seconds % 60);
+	Time_Ptr->weekday = (RTC_WeekdayType)((days + RTC_BASE_WEEKDAY) % 7);
+
+	Time_Ptr->year = 0;
+	for(;;){
+		length = RTC_IS_LEAP_YEAR(Time_Ptr->year) ? 366 : 365;
+		if(days < length){
+			break;
+		}
+		days -= length;
+		Time_Ptr->year++;
+	}
+
+	Time_Ptr->month = 1;
+	for(;;){
+		length = RTC_daysInMonth(Time_Ptr->month,Time_Ptr->year);
+		if(days < length){
+			break;
+		}
+		days -= length;
+		Time_Ptr->month++;
+	}
+	Time_Ptr->day = (uint8)days + 1;
+}
+
+/*
+ * Description :
+ * call-back function of the 1 ms tick, the context is the clock to update.
+ */
+static void RTC_tickCallBack(void * context){
+	PROBE_BEGIN(PROBE_RTC_TICK);
+	volatile RTC_ClockType * Clock_Ptr = context;
+
+	Clock_Ptr->milliseconds++;
+	Clock_Ptr->subSecond++;
+	if(Clock_Ptr->subSecond == 1000){
+		Clock_Ptr->subSecond = 0;
+		Clock_Ptr->epoch++;
+	}
+	PROBE_END(PROBE_RTC_TICK);
+}
+
+/*
+ * Description :
+ * Read a 32-bit value shared with the tick interrupt, the AVR reads it one byte at a time.
+ */
+static uint32 RTC_readAtomic(volatile uint32 * value){
+	uint32 copy;
+	uint8 interrupts = SREG_REG.bits.I_bit;
+
+	SREG_REG.bits.I_bit = LOGIC_LOW;
+	copy = *value;
+	SREG_REG.bits.I_bit = interrupts;
+	return copy;
+}
+
+/*
+ * Description :
+ * Return the number of days in the month (1 - 12) of the year since 2000.
+ */
+static uint8 RTC_daysInMonth(uint8 month, uint8 year){
+	if((month == 2) && RTC_IS_LEAP_YEAR(year)){
+		return 29;
+	}
+	return pgm_read_byte(&g_daysInMonth[month - 1]);
+}
+
+/*
+ * Description :
+ * Save the calendar time in the internal EEPROM.
+ */
+static void RTC_save(uint32 epoch){
+	g_savedEpoch = epoch;
+	eeprom_update_block(&g_savedEpoch, &g_epochEeprom, sizeof(uint32));
+}
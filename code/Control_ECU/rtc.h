@@ -0,0 +1,110 @@
+/*
+ ============================================================================
+ Name        : rtc.h
+ Author      : Aziza Zamel
+ Description : Header file for the system tick and the calendar clock
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef RTC_H_
+#define RTC_H_
+
+#include "std_types.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* The calendar time is kept as seconds since 01/01/2000 00:00:00, valid until 2099 */
+#define RTC_BASE_YEAR			2000
+#define RTC_MAX_YEAR			99
+
+/*
+ * The calendar time is saved in the internal EEPROM every hour. After a reset the clock restarts from
+ * the saved time, an approximate lower bound, and it is not set until the admin sets it again.
+ */
+#define RTC_SAVE_PERIOD_SECONDS	3600
+
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef enum{
+	RTC_MONDAY,RTC_TUESDAY,RTC_WEDNESDAY,RTC_THURSDAY,RTC_FRIDAY,RTC_SATURDAY,RTC_SUNDAY
+}RTC_WeekdayType;
+
+typedef struct{
+	uint8 seconds;
+	uint8 minutes;
+	uint8 hours;
+	uint8 day;				/* 1 - 31 */
+	uint8 month;			/* 1 - 12 */
+	uint8 year;				/* years since 2000 */
+	RTC_WeekdayType weekday;
+}RTC_TimeType;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for starting the 1 ms tick on Timer2 and loading the last saved calendar time.
+ * The clock stays not set until RTC_setTime, the saved time is only a lower bound of the real time.
+ */
+void RTC_init(void);
+
+/*
+ * Description :
+ * Function responsible for saving the calendar time every RTC_SAVE_PERIOD_SECONDS, call it from the main loop.
+ */
+void RTC_update(void);
+
+/*
+ * Description :
+ * Function responsible for returning the milliseconds since start up, it rolls over after 49 days.
+ */
+uint32 RTC_getMilliseconds(void);
+
+/*
+ * Description :
+ * Function responsible for checking if the duration passed since start, it works across the rollover.
+ */
+boolean RTC_isElapsed(uint32 start, uint32 duration);
+
+/*
+ * Description :
+ * Function responsible for returning the calendar time in seconds since 01/01/2000.
+ */
+uint32 RTC_getEpoch(void);
+
+/*
+ * Description :
+ * Function responsible for returning TRUE if the calendar time was set since the last reset.
+ */
+boolean RTC_isSet(void);
+
+/*
+ * Description :
+ * Function responsible for setting the calendar time and saving it.
+ * Return FALSE if the time is not a valid date between 2000 and 2099.
+ */
+boolean RTC_setTime(const RTC_TimeType * Time_Ptr);
+
+/*
+ * Description :
+ * Function responsible for reading the calendar time.
+ */
+void RTC_getTime(RTC_TimeType * Time_Ptr);
+
+/*
+ * Description :
+ * Function responsible for converting seconds since 01/01/2000 to date and time.
+ */
+void RTC_epochToTime(uint32 epoch, RTC_TimeType * Time_Ptr);
+
+#endif /* RTC_H_ */
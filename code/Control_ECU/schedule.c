@@ -0,0 +1,218 @@
+/*
+ ============================================================================
+ Name        : schedule.c
+ Author      : Aziza Zamel
+ Description : Source file for the weekly access schedules
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#include "schedule.h"
+#include "users.h"
+#include "rtc.h"
+#include "external_eeprom.h"
+#include "common_macros.h"
+#include "util/delay.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SCHEDULE_SECONDS_PER_DAY	86400UL
+#define SCHEDULE_SLOT_SECONDS		(SCHEDULE_SLOT_MINUTES * 60U)
+
+/* The bitmaps are written one EEPROM page at a time */
+#define SCHEDULE_PAGE_SIZE			16
+
+#define SCHEDULE_PROFILE_ADDRESS(PROFILE)	(SCHEDULE_PROFILES_ADDRESS + ((uint16)(PROFILE) * SCHEDULE_PROFILE_SIZE))
+
+/* Bytes written for a profile, the bitmap then the marker */
+#define SCHEDULE_RECORD_SIZE		(SCHEDULE_BITMAP_SIZE + 1)
+
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Profile of each user slot */
+static uint8 g_profiles[USERS_MAX_COUNT];
+
+/* Bit of each profile whose bitmap was written, the others allow no slot */
+static uint8 g_formatted = 0;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint8 Schedule_writeBitmap(uint8 profile, uint8 * bitmap);
+
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for loading the profile of every user slot and the formatted profiles into RAM.
+ * The slots that can't be read have no restrictions, like the erased EEPROM.
+ */
+void Schedule_init(void){
+	uint8 slot, profile, marker;
+
+	if(EEPROM_readData(SCHEDULE_ASSIGN_ADDRESS, g_profiles, USERS_MAX_COUNT) != SUCCESS){
+		for(slot = 0 ; slot < USERS_MAX_COUNT ; slot++){
+			g_profiles[slot] = SCHEDULE_NO_PROFILE;
+		}
+	}
+
+	for(profile = 0 ; profile < SCHEDULE_MAX_PROFILES ; profile++){
+		if((EEPROM_readByte(SCHEDULE_PROFILE_ADDRESS(profile) + SCHEDULE_MARKER_OFFSET, &marker) == SUCCESS)
+				&& (marker == SCHEDULE_FORMATTED)){
+			SET_BIT(g_formatted, profile);
+		}
+	}
+}
+
+/*
+ * Description :
+ * Function responsible for checking if the user slot may enter at the time (seconds since 01/01/2000).
+ */
+boolean Schedule_isAllowed(uint8 slot, uint32 time){
+	uint16 days, bit;
+	uint8 bitmap_byte;
+
+	if(slot >= USERS_MAX_COUNT){
+		return FALSE;
+	}
+	if(g_profiles[slot] >= SCHEDULE_MAX_PROFILES){
+		return TRUE;
+	}
+	/* Without a set clock the time of the restricted users is unknown, and a profile never written has no rules */
+	if(!RTC_isSet() || !GET_BIT(g_formatted, g_profiles[slot])){
+		return FALSE;
+	}
+
+	days = (uint16)(time / SCHEDULE_SECONDS_PER_DAY);
+	bit = (((days + RTC_SATURDAY) % SCHEDULE_DAYS) * SCHEDULE_SLOTS_PER_DAY)
+			+ (uint16)((time % SCHEDULE_SECONDS_PER_DAY) / SCHEDULE_SLOT_SECONDS);
+
+	/* A read error denies the access */
+	if(EEPROM_readByte(SCHEDULE_PROFILE_ADDRESS(g_profiles[slot]) + (bit >> 3), &bitmap_byte) != SUCCESS){
+		return FALSE;
+	}
+	return GET_BIT(bitmap_byte, (bit & 7));
+}
+
+/*
+ * Description :
+ * Function responsible for giving the user slot a profile, or SCHEDULE_NO_PROFILE to remove its restrictions.
+ * Return SUCCESS or ERROR.
+ */
+uint8 Schedule_assign(uint8 slot, uint8 profile){
+	if((slot >= USERS_MAX_COUNT) || ((profile >= SCHEDULE_MAX_PROFILES) && (profile != SCHEDULE_NO_PROFILE))){
+		return ERROR;
+	}
+	if(g_profiles[slot] == profile){
+		return SUCCESS;
+	}
+	g_profiles[slot] = profile;
+	if(EEPROM_writeByte(SCHEDULE_ASSIGN_ADDRESS + slot, profile) != SUCCESS){
+		return ERROR;
+	}
+	/* wait for the EEPROM write cycle */
+	_delay_ms(10);
+	return SUCCESS;
+}
+
+/*
+ * Description :
+ * Function responsible for clearing the profile, its users aren't allowed at any time until rules are added.
+ * Return SUCCESS or ERROR.
+ */
+uint8 Schedule_clearProfile(uint8 profile){
+	uint8 bitmap[SCHEDULE_RECORD_SIZE];
+	uint8 i;
+
+	if(profile >= SCHEDULE_MAX_PROFILES){
+		return ERROR;
+	}
+	for(i = 0 ; i < SCHEDULE_BITMAP_SIZE ; i++){
+		bitmap[i] = 0;
+	}
+	return Schedule_writeBitmap(profile, bitmap);
+}
+
+/*
+ * Description :
+ * Function responsible for compiling the rule "allowed from first_day to last_day, from start_slot to end_slot"
+ * into the profile bitmap. Days are 0 (Monday) to 6, end_slot is excluded (48 = midnight).
+ * Return SUCCESS or ERROR.
+ */
+uint8 Schedule_addRule(uint8 profile, uint8 first_day, uint8 last_day, uint8 start_slot, uint8 end_slot){
+	uint8 bitmap[SCHEDULE_RECORD_SIZE];
+	uint16 bit;
+	uint8 day, slot, i;
+
+	if((profile >= SCHEDULE_MAX_PROFILES) || (first_day > last_day) || (last_day >= SCHEDULE_DAYS)
+			|| (start_slot >= end_slot) || (end_slot > SCHEDULE_SLOTS_PER_DAY)){
+		return ERROR;
+	}
+	if(EEPROM_readData(SCHEDULE_PROFILE_ADDRESS(profile), bitmap, SCHEDULE_RECORD_SIZE) != SUCCESS){
+		return ERROR;
+	}
+	/* the first rule of a profile never written starts from an empty bitmap, not from the erased one */
+	if(bitmap[SCHEDULE_MARKER_OFFSET] != SCHEDULE_FORMATTED){
+		for(i = 0 ; i < SCHEDULE_BITMAP_SIZE ; i++){
+			bitmap[i] = 0;
+		}
+	}
+
+	for(day = first_day ; day <= last_day ; day++){
+		bit = (uint16)day * SCHEDULE_SLOTS_PER_DAY;
+		for(slot = start_slot ; slot < end_slot ; slot++){
+			SET_BIT(bitmap[(bit + slot) >> 3], ((bit + slot) & 7));
+		}
+	}
+	return Schedule_writeBitmap(profile, bitmap);
+}
+
+/*
+ * Description :
+ * Write the bitmap of the profile then its marker page by page, the pages that didn't change are not written.
+ * The marker is in the last page, so a bitmap interrupted by a reset stays not formatted.
+ */
+static uint8 Schedule_writeBitmap(uint8 profile, uint8 * bitmap){
+	uint8 page[SCHEDULE_PAGE_SIZE];
+	uint8 offset, size, i;
+	boolean changed;
+
+	bitmap[SCHEDULE_MARKER_OFFSET] = SCHEDULE_FORMATTED;
+	for(offset = 0 ; offset < SCHEDULE_RECORD_SIZE ; offset += SCHEDULE_PAGE_SIZE){
+		size = SCHEDULE_RECORD_SIZE - offset;
+		if(size > SCHEDULE_PAGE_SIZE){
+			size = SCHEDULE_PAGE_SIZE;
+		}
+		if(EEPROM_readData(SCHEDULE_PROFILE_ADDRESS(profile) + offset, page, size) != SUCCESS){
+			return ERROR;
+		}
+
+		changed = FALSE;
+		for(i = 0 ; i < size ; i++){
+			if(page[i] != bitmap[offset + i]){
+				page[i] = bitmap[offset + i];
+				changed = TRUE;
+			}
+		}
+		if(changed){
+			if(EEPROM_writeData(SCHEDULE_PROFILE_ADDRESS(profile) + offset, page, size) != SUCCESS){
+				return ERROR;
+			}
+			/* wait for the EEPROM write cycle */
+			_delay_ms(10);
+		}
+	}
+	SET_BIT(g_formatted, profile);
+	return SUCCESS;
+}
@@ -0,0 +1,89 @@
+/*
+ ============================================================================
+ Name        : schedule.h
+ Author      : Aziza Zamel
+ Description : Header file for the weekly access schedules
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef SCHEDULE_H_
+#define SCHEDULE_H_
+
+#include "std_types.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * A profile is a weekly bitmap of 30 minutes slots, bit (day * 48 + slot) is set if access is allowed.
+ * Monday is day 0. The rules are compiled into the bitmap when they are entered,
+ * so an access decision is one byte read and one bit test.
+ */
+#define SCHEDULE_SLOT_MINUTES		30
+#define SCHEDULE_SLOTS_PER_DAY		48
+#define SCHEDULE_DAYS				7
+#define SCHEDULE_BITMAP_SIZE		((SCHEDULE_DAYS * SCHEDULE_SLOTS_PER_DAY) / 8)
+
+/* Profiles take 3 EEPROM pages each (43 bytes used) between 0x0200 and 0x02EF */
+#define SCHEDULE_PROFILES_ADDRESS	0x0200
+#define SCHEDULE_PROFILE_SIZE		48
+#define SCHEDULE_MAX_PROFILES		5
+
+/*
+ * The byte after the bitmap holds SCHEDULE_FORMATTED once the bitmap was written.
+ * The erased bitmap would allow every slot, so a profile without it allows none,
+ * and the first rule added to it starts from an empty bitmap.
+ */
+#define SCHEDULE_MARKER_OFFSET		SCHEDULE_BITMAP_SIZE
+#define SCHEDULE_FORMATTED			0x5A
+
+/* Profile of each user slot, one byte per slot between 0x0380 and 0x03BF */
+#define SCHEDULE_ASSIGN_ADDRESS		0x0380
+
+/* Profile of the users without time restrictions, it is also the erased EEPROM value */
+#define SCHEDULE_NO_PROFILE			0xFF
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for loading the profile of every user slot and the formatted profiles into RAM.
+ */
+void Schedule_init(void);
+
+/*
+ * Description :
+ * Function responsible for checking if the user slot may enter at the time (seconds since 01/01/2000).
+ * Users with a profile are refused while the clock is not set.
+ */
+boolean Schedule_isAllowed(uint8 slot, uint32 time);
+
+/*
+ * Description :
+ * Function responsible for giving the user slot a profile, or SCHEDULE_NO_PROFILE to remove its restrictions.
+ * Return SUCCESS or ERROR.
+ */
+uint8 Schedule_assign(uint8 slot, uint8 profile);
+
+/*
+ * Description :
+ * Function responsible for clearing the profile, its users aren't allowed at any time until rules are added.
+ * Return SUCCESS or ERROR.
+ */
+uint8 Schedule_clearProfile(uint8 profile);
+
+/*
+ * Description :
+ * Function responsible for compiling the rule "allowed from first_day to last_day, from start_slot to end_slot"
+ * into the profile bitmap. Days are 0 (Monday) to 6, end_slot is excluded (48 = midnight).
+ * Return SUCCESS or ERROR.
+ */
+uint8 Schedule_addRule(uint8 profile, uint8 first_day, uint8 last_day, uint8 start_slot, uint8 end_slot);
+
+#endif /* SCHEDULE_H_ */
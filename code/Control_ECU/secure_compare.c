@@ -0,0 +1,34 @@
+/*
+ ============================================================================
+ Name        : secure_compare.c
+ Author      : Aziza Zamel
+ Description : Source file for the constant-time compare used by all credential checks
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#include "secure_compare.h"
+
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for comparing two buffers of the same length.
+ * All the bytes are always compared, so the execution time doesn't depend on where they differ.
+ * Return TRUE if the two buffers are equal.
+ */
+boolean SecureCompare_equal(const uint8 * first, const uint8 * second, uint8 length){
+	/* volatile stops the compiler from leaving the loop early once the result is known */
+	volatile uint8 difference = 0;
+	uint8 i;
+
+	for(i = 0 ; i < length ; i++){
+		difference |= first[i] ^ second[i];
+	}
+
+	/* Turn any non zero difference into 1 without a data dependent branch */
+	return (boolean)(1 & ((uint16)(difference - 1) >> 8));
+}
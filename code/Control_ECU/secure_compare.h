@@ -0,0 +1,28 @@
+/*
+ ============================================================================
+ Name        : secure_compare.h
+ Author      : Aziza Zamel
+ Description : Header file for the constant-time compare used by all credential checks
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef SECURE_COMPARE_H_
+#define SECURE_COMPARE_H_
+
+#include "std_types.h"
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for comparing two buffers of the same length.
+ * All the bytes are always compared, so the execution time doesn't depend on where they differ.
+ * Return TRUE if the two buffers are equal.
+ */
+boolean SecureCompare_equal(const uint8 * first, const uint8 * second, uint8 length);
+
+#endif /* SECURE_COMPARE_H_ */
@@ -0,0 +1,437 @@
+/*
+ ============================================================================
+ Name        : secure_link.c
+ Author      : Aziza Zamel
+ Description : Source file for the authenticated and encrypted UART link
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#include "secure_link.h"
+#include "uart.h"
+#include "secure_compare.h"
+#include "avr/eeprom.h"
+#ifdef SECURE_LINK_FRAME_POOL
+#include "probe.h"
+#include "power.h"
+#include "ATmega32_Registers.h"
+#endif
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define XTEA_NUM_OF_CYCLES		32
+#define XTEA_DELTA				0x9E3779B9UL
+
+/* Constant used to derive the MAC key from the link key */
+#define SECURE_LINK_MAC_KEY_MASK	0x5C5C5C5CUL
+
+/* Value read from an erased EEPROM location */
+#define SECURE_LINK_ERASED_COUNTER	0xFFFFFFFFUL
+
+/* Bytes of a frame around its payload */
+#define SECURE_LINK_OVERHEAD		(1 + SECURE_LINK_COUNTER_SIZE + SECURE_LINK_TAG_SIZE)
+
+
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+#ifdef SECURE_LINK_FRAME_POOL
+/* State of a frame received in place, one byte at a time */
+typedef struct{
+	FramePool_FrameType * frame;
+	uint16 position;				/* bytes of the frame received */
+	uint16 size;					/* bytes of the whole frame, known after the length byte */
+	volatile uint8 received;		/* bytes received, it rolls over, it only shows the progress */
+	volatile boolean complete;
+}SecureLink_ReceiverType;
+#endif
+
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Link key and nonce counters kept in the internal EEPROM */
+static uint8 EEMEM g_linkKeyEeprom[SECURE_LINK_KEY_SIZE] = SECURE_LINK_DEFAULT_KEY;
+static uint32 EEMEM g_txReservationEeprom = 0;
+static uint32 EEMEM g_rxReservationEeprom = 0;
+
+static uint32 g_cipherKey[4];
+static uint32 g_macKey[4];
+
+/* Last used TX counter and the highest TX counter saved in EEPROM */
+static uint32 g_txCounter;
+static uint32 g_txReservation;
+
+/* Last accepted RX counter, any frame with a lower or equal counter is a replay */
+static uint32 g_rxCounter;
+
+/* End of the peer block of counters that holds g_rxCounter, it is saved in EEPROM instead of g_rxCounter */
+static uint32 g_rxReservation;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void XTEA_encryptBlock(uint32 * block, const uint32 * key);
+static void SecureLink_crypt(uint8 * data, uint8 length, uint32 counter, uint8 node_id);
+static void SecureLink_mac(const uint8 * data, uint8 length, uint32 counter, uint8 node_id, uint8 * tag);
+static boolean SecureLink_receiveBytes(uint8 * data, uint8 count);
+static boolean SecureLink_open(uint8 * data, uint8 length, const uint8 * counter_bytes, const uint8 * received_tag);
+#ifdef SECURE_LINK_FRAME_POOL
+static boolean SecureLink_receiveInPlace(uint8 data, void * context);
+#endif
+
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for loading the link key and the nonce counters from the internal EEPROM.
+ */
+void SecureLink_init(void){
+	uint8 key[SECURE_LINK_KEY_SIZE];
+	uint8 i;
+
+	eeprom_read_block(key, g_linkKeyEeprom, SECURE_LINK_KEY_SIZE);
+	for(i = 0 ; i < 4 ; i++){
+		g_cipherKey[i] = (uint32)key[4*i] | ((uint32)key[4*i+1] << 8)
+				| ((uint32)key[4*i+2] << 16) | ((uint32)key[4*i+3] << 24);
+		g_macKey[i] = g_cipherKey[i] ^ SECURE_LINK_MAC_KEY_MASK;
+	}
+
+	eeprom_read_block(&g_txReservation, &g_txReservationEeprom, sizeof(uint32));
+	eeprom_read_block(&g_rxReservation, &g_rxReservationEeprom, sizeof(uint32));
+
+	/* Start from zero if the EEPROM was erased without writing the .eep image */
+	if(g_txReservation == SECURE_LINK_ERASED_COUNTER){
+		g_txReservation = 0;
+	}
+	if(g_rxReservation == SECURE_LINK_ERASED_COUNTER){
+		g_rxReservation = 0;
+	}
+
+	/* Counters up to the saved reservation may be used before reset, never reuse them */
+	g_txCounter = g_txReservation;
+	/* The counters accepted before reset are at most the end of the saved peer block, the rest of it is refused */
+	g_rxCounter = g_rxReservation;
+}
+
+/*
+ * Description :
+ * Function responsible for sending the next frames from a new block of counters.
+ */
+void SecureLink_skipReservation(void){
+	g_txCounter = g_txReservation;
+}
+
+/*
+ * Description :
+ * Function responsible for encrypting, authenticating and sending one frame through UART.
+ */
+void SecureLink_send(const uint8 * data, uint8 length){
+	uint8 buffer[SECURE_LINK_MAX_PAYLOAD];
+	uint8 tag[SECURE_LINK_TAG_SIZE];
+	uint8 i;
+
+	if(length > SECURE_LINK_MAX_PAYLOAD){
+		length = SECURE_LINK_MAX_PAYLOAD;
+	}
+
+	/* Save a new block of counters in EEPROM only when the reserved one is used up */
+	if(g_txCounter == g_txReservation){
+		g_txReservation += SECURE_LINK_COUNTER_RESERVATION;
+		eeprom_update_block(&g_txReservation, &g_txReservationEeprom, sizeof(uint32));
+	}
+	g_txCounter++;
+
+	for(i = 0 ; i < length ; i++){
+		buffer[i] = data[i];
+	}
+	/* Encrypt then authenticate the cipher text */
+	SecureLink_crypt(buffer, length, g_txCounter, SECURE_LINK_NODE_ID);
+	SecureLink_mac(buffer, length, g_txCounter, SECURE_LINK_NODE_ID, tag);
+
+	UART_sendByte(length);
+	for(i = 0 ; i < SECURE_LINK_COUNTER_SIZE ; i++){
+		UART_sendByte((uint8)(g_txCounter >> (8*i)));
+	}
+	for(i = 0 ; i < length ; i++){
+		UART_sendByte(buffer[i]);
+	}
+	for(i = 0 ; i < SECURE_LINK_TAG_SIZE ; i++){
+		UART_sendByte(tag[i]);
+	}
+}
+
+/*
+ * Description :
+ * Function responsible for receiving one frame through UART, checking its tag and counter and decrypting it.
+ * Return the payload length, or 0 if the frame is too long, truncated, forged or replayed.
+ */
+uint8 SecureLink_receive(uint8 * data, uint8 max_length){
+	uint8 tag[SECURE_LINK_TAG_SIZE], received_tag[SECURE_LINK_TAG_SIZE];
+	uint8 counter_bytes[SECURE_LINK_COUNTER_SIZE];
+	uint8 length, i;
+
+	/* the frame may start at any time, but its other bytes are sent together */
+	length = UART_recieveByte();
+	if((length > max_length) || (length > SECURE_LINK_MAX_PAYLOAD)){
+		/* drop the rest of the frame, so its bytes aren't taken as the next commands */
+		for(i = 0 ; i < length ; i++){
+			if(!SecureLink_receiveBytes(tag, 1)){
+				return 0;
+			}
+		}
+		SecureLink_receiveBytes(received_tag, SECURE_LINK_COUNTER_SIZE);
+		SecureLink_receiveBytes(received_tag, SECURE_LINK_TAG_SIZE);
+		return 0;
+	}
+
+	/* a truncated frame is rejected instead of waiting for ever */
+	if(!SecureLink_receiveBytes(counter_bytes, SECURE_LINK_COUNTER_SIZE) || !SecureLink_receiveBytes(data, length)
+			|| !SecureLink_receiveBytes(received_tag, SECURE_LINK_TAG_SIZE)){
+		return 0;
+	}
+	if(!SecureLink_open(data, length, counter_bytes, received_tag)){
+		return 0;
+	}
+	return length;
+}
+
+#ifdef SECURE_LINK_FRAME_POOL
+/*
+ * Description :
+ * Function responsible for receiving one frame like SecureLink_receive, into a frame taken from the pool.
+ * The caller owns the returned frame and gives it back with FramePool_free.
+ * Return NULL_PTR if the frame is rejected, the pool is empty or the frame doesn't start within
+ * SECURE_LINK_FRAME_TIMEOUT_MS, the frame is dropped then.
+ */
+FramePool_FrameType * SecureLink_receiveFrame(void){
+	SecureLink_ReceiverType receiver;
+	uint8 data;
+#ifdef RX_INTERRUPT
+	uint8 progress = 0;
+	uint16 ticks = SECURE_LINK_FRAME_TIMEOUT_MS;
+#endif
+
+	receiver.frame = FramePool_alloc();
+	if(receiver.frame == NULL_PTR){
+		/* no room for the payload, receive the frame with no room so all its bytes are dropped */
+		SecureLink_receive(&data, 0);
+		return NULL_PTR;
+	}
+	receiver.position = 0;
+	receiver.size = 1;
+	receiver.received = 0;
+	receiver.complete = FALSE;
+
+#ifdef RX_INTERRUPT
+	/*
+	 * The RX interrupt writes the frame, the frame may start up to SECURE_LINK_FRAME_TIMEOUT_MS later but
+	 * its other bytes are sent together. The MCU sleeps meanwhile, the 1 ms tick of both ECUs or the next
+	 * byte wakes it, so the wake ups without a new byte count the milliseconds (other interrupts shorten the wait).
+	 */
+	UART_setRxHook(SecureLink_receiveInPlace, &receiver);
+	for(;;){
+		/* check with the interrupts disabled, so a byte received just before the sleep instruction still wakes the MCU */
+		SREG_REG.bits.I_bit = LOGIC_LOW;
+		if(receiver.complete){
+			SREG_REG.bits.I_bit = LOGIC_HIGH;
+			break;
+		}
+		if(receiver.received != progress){
+			progress = receiver.received;
+			ticks = SECURE_LINK_BYTE_TIMEOUT_MS;
+		}else if(ticks == 0){
+			/* a lost or truncated frame is rejected instead of waiting for ever */
+			SREG_REG.bits.I_bit = LOGIC_HIGH;
+			UART_setRxHook(NULL_PTR, NULL_PTR);
+			FramePool_free(receiver.frame);
+			return NULL_PTR;
+		}else{
+			ticks--;
+		}
+		Power_sleep(POWER_IDLE);
+	}
+#else
+	if(!UART_receiveByteTimeout(&data, SECURE_LINK_FRAME_TIMEOUT_MS)){
+		FramePool_free(receiver.frame);
+		return NULL_PTR;
+	}
+	while(SecureLink_receiveInPlace(data, &receiver)){
+		/* a truncated frame is rejected instead of waiting for ever */
+		if(!UART_receiveByteTimeout(&data, SECURE_LINK_BYTE_TIMEOUT_MS)){
+			FramePool_free(receiver.frame);
+			return NULL_PTR;
+		}
+	}
+#endif
+
+	/* the payload of a too long frame was dropped while it was received */
+	if((receiver.frame->length > SECURE_LINK_MAX_PAYLOAD)
+			|| !SecureLink_open(receiver.frame->data, receiver.frame->length, receiver.frame->header, receiver.frame->trailer)){
+		FramePool_free(receiver.frame);
+		return NULL_PTR;
+	}
+	return receiver.frame;
+}
+#endif
+
+/*
+ * Description :
+ * Encrypt one 64-bit block with XTEA (32 cycles, 128-bit key).
+ */
+static void XTEA_encryptBlock(uint32 * block, const uint32 * key){
+	uint32 v0 = block[0], v1 = block[1], sum = 0;
+	uint8 cycle;
+
+	for(cycle = 0 ; cycle < XTEA_NUM_OF_CYCLES ; cycle++){
+		v0 += (((v1 << 4) ^ (v1 >> 5)) + v1) ^ (sum + key[sum & 3]);
+		sum += XTEA_DELTA;
+		v1 += (((v0 << 4) ^ (v0 >> 5)) + v0) ^ (sum + key[(sum >> 11) & 3]);
+	}
+	block[0] = v0;
+	block[1] = v1;
+}
+
+/*
+ * Description :
+ * XOR the data with the CTR key stream, the same call encrypts and decrypts.
+ * Key stream block = XTEA(counter | node_id | block index).
+ */
+static void SecureLink_crypt(uint8 * data, uint8 length, uint32 counter, uint8 node_id){
+	uint32 block[2] = {0,0};
+	uint8 i;
+
+	for(i = 0 ; i < length ; i++){
+		if((i & 7) == 0){
+			block[0] = counter;
+			block[1] = ((uint32)node_id << 24) | (i >> 3);
+			XTEA_encryptBlock(block, g_cipherKey);
+		}
+		data[i] ^= (uint8)(block[(i >> 2) & 1] >> (8*(i & 3)));
+	}
+}
+
+/*
+ * Description :
+ * Calculate the CBC-MAC of the data with the MAC key.
+ * The first block holds the counter, the node id and the length, so frames of different lengths can't be mixed.
+ */
+static void SecureLink_mac(const uint8 * data, uint8 length, uint32 counter, uint8 node_id, uint8 * tag){
+	uint32 state[2];
+	uint8 i;
+
+	state[0] = counter;
+	state[1] = ((uint32)node_id << 24) | length;
+	XTEA_encryptBlock(state, g_macKey);
+
+	for(i = 0 ; i < length ; i++){
+		state[(i >> 2) & 1] ^= (uint32)data[i] << (8*(i & 3));
+		/* The last block is padded with zeros */
+		if(((i & 7) == 7) || (i == (length - 1))){
+			XTEA_encryptBlock(state, g_macKey);
+		}
+	}
+
+	for(i = 0 ; i < SECURE_LINK_TAG_SIZE ; i++){
+		tag[i] = (uint8)(state[0] >> (8*i));
+	}
+}
+
+/*
+ * Description :
+ * Receive count bytes of a frame, return FALSE if one of them doesn't arrive within SECURE_LINK_BYTE_TIMEOUT_MS.
+ */
+static boolean SecureLink_receiveBytes(uint8 * data, uint8 count){
+	uint8 i;
+
+	for(i = 0 ; i < count ; i++){
+		if(!UART_receiveByteTimeout(&data[i], SECURE_LINK_BYTE_TIMEOUT_MS)){
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Check the tag and the counter of a received frame, then decrypt it in place.
+ * Return FALSE if the frame is forged or replayed.
+ */
+static boolean SecureLink_open(uint8 * data, uint8 length, const uint8 * counter_bytes, const uint8 * received_tag){
+	uint8 tag[SECURE_LINK_TAG_SIZE];
+	uint32 counter = 0;
+	uint8 i;
+
+	for(i = 0 ; i < SECURE_LINK_COUNTER_SIZE ; i++){
+		counter |= (uint32)counter_bytes[i] << (8*i);
+	}
+
+	/* Compare the tags in constant time, so a forger can't learn the correct prefix */
+	SecureLink_mac(data, length, counter, SECURE_LINK_PEER_ID, tag);
+	if(!SecureCompare_equal(tag, received_tag, SECURE_LINK_TAG_SIZE) || (counter <= g_rxCounter)){
+		return FALSE;
+	}
+
+	/* Remember the counter so the same frame can't be accepted again, even after reset.
+	 * The peer reserves its counters in blocks of SECURE_LINK_COUNTER_RESERVATION, so saving the end
+	 * of the block only when a new block starts writes the EEPROM once per block instead of once per frame */
+	g_rxCounter = counter;
+	if(counter > g_rxReservation){
+		g_rxReservation = ((counter + SECURE_LINK_COUNTER_RESERVATION - 1) / SECURE_LINK_COUNTER_RESERVATION)
+				* SECURE_LINK_COUNTER_RESERVATION;
+		eeprom_update_block(&g_rxReservation, &g_rxReservationEeprom, sizeof(uint32));
+	}
+
+	SecureLink_crypt(data, length, counter, SECURE_LINK_PEER_ID);
+	return TRUE;
+}
+
+#ifdef SECURE_LINK_FRAME_POOL
+/*
+ * Description :
+ * Write the next byte of the frame in its place in the pool frame, the payload of a too long frame is dropped.
+ * Return FALSE after the last byte of the frame. It is called from the RX interrupt when RX_INTERRUPT is defined.
+ */
+static boolean SecureLink_receiveInPlace(uint8 data, void * context){
+	SecureLink_ReceiverType * Receiver_Ptr = context;
+	FramePool_FrameType * Frame_Ptr = Receiver_Ptr->frame;
+	uint16 offset = Receiver_Ptr->position;
+	boolean more = TRUE;
+
+	/* the interrupt entry and its register saving are not measured */
+	PROBE_BEGIN(PROBE_FRAME_BYTE);
+	if(offset == 0){
+		Frame_Ptr->length = data;
+		Receiver_Ptr->size = SECURE_LINK_OVERHEAD + data;
+	}else if(offset <= SECURE_LINK_COUNTER_SIZE){
+		Frame_Ptr->header[offset - 1] = data;
+	}else{
+		offset -= (1 + SECURE_LINK_COUNTER_SIZE);
+		if(offset >= Frame_Ptr->length){
+			Frame_Ptr->trailer[offset - Frame_Ptr->length] = data;
+		}else if(Frame_Ptr->length <= SECURE_LINK_MAX_PAYLOAD){
+			Frame_Ptr->data[offset] = data;
+		}
+	}
+
+	Receiver_Ptr->position++;
+	Receiver_Ptr->received++;
+	if(Receiver_Ptr->position == Receiver_Ptr->size){
+		Receiver_Ptr->complete = TRUE;
+		more = FALSE;
+	}
+	PROBE_END(PROBE_FRAME_BYTE);
+	return more;
+}
+#endif
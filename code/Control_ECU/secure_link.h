@@ -0,0 +1,111 @@
+/*
+ ============================================================================
+ Name        : secure_link.h
+ Author      : Aziza Zamel
+ Description : Header file for the authenticated and encrypted UART link
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef SECURE_LINK_H_
+#define SECURE_LINK_H_
+
+#include "std_types.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Receive frames in place into the frame pool with SecureLink_receiveFrame, only the ECUs with a pool define it */
+#define SECURE_LINK_FRAME_POOL
+
+#ifdef SECURE_LINK_FRAME_POOL
+#include "frame_pool.h"
+#endif
+
+/* Node IDs, mixed in every nonce so the two directions never share a key stream */
+#define SECURE_LINK_NODE_ID				0x02	/* Control_ECU */
+#define SECURE_LINK_PEER_ID				0x01	/* HMI_ECU */
+
+#define SECURE_LINK_KEY_SIZE			16
+#define SECURE_LINK_COUNTER_SIZE		4
+#define SECURE_LINK_TAG_SIZE			4
+#define SECURE_LINK_MAX_PAYLOAD			16
+
+/* Longest gap allowed between the bytes of one frame, a byte takes about 1 ms at 9600 bits/sec */
+#define SECURE_LINK_BYTE_TIMEOUT_MS		20
+
+/* Longest wait for the first byte of a frame received in place, the user may type it on HMI_ECU meanwhile */
+#define SECURE_LINK_FRAME_TIMEOUT_MS	30000
+
+/*
+ * Number of TX counter values reserved by each internal EEPROM write.
+ * The receiver saves the end of the block in use instead of every counter, both ECUs must use the same value.
+ */
+#define SECURE_LINK_COUNTER_RESERVATION	32
+
+/*
+ * Default link key written to the internal EEPROM image (.eep file).
+ * Every unit must be programmed with its own key, the same one in both ECUs.
+ */
+#define SECURE_LINK_DEFAULT_KEY		{0x3A,0x91,0x5C,0x07,0xE2,0x48,0xB6,0x1F, \
+									 0x6D,0xC3,0x29,0x84,0xF0,0x57,0xAE,0x12}
+
+/*
+ * Frame format on the wire:
+ * | length (1) | counter (4) | ciphertext (length) | tag (4) |
+ * The payload is encrypted with XTEA in CTR mode, then the counter, the length and
+ * the ciphertext are authenticated with XTEA CBC-MAC using a derived key.
+ */
+
+#if defined(SECURE_LINK_FRAME_POOL) && ((SECURE_LINK_MAX_PAYLOAD > FRAME_POOL_FRAME_SIZE) || (SECURE_LINK_COUNTER_SIZE > FRAME_POOL_HEADER_SIZE) \
+		|| (SECURE_LINK_TAG_SIZE > FRAME_POOL_TRAILER_SIZE))
+#error "A secure link frame doesn't fit in a pool frame"
+#endif
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for loading the link key and the nonce counters from the internal EEPROM.
+ */
+void SecureLink_init(void);
+
+/*
+ * Description :
+ * Function responsible for encrypting, authenticating and sending one frame through UART.
+ */
+void SecureLink_send(const uint8 * data, uint8 length);
+
+/*
+ * Description :
+ * Function responsible for sending the next frames from a new block of counters.
+ * Call it when the link is negotiated again, a peer reset since the last frame refuses the rest of the block in use.
+ */
+void SecureLink_skipReservation(void);
+
+/*
+ * Description :
+ * Function responsible for receiving one frame through UART, checking its tag and counter and decrypting it.
+ * Return the payload length, or 0 if the frame is too long, truncated, forged or replayed.
+ */
+uint8 SecureLink_receive(uint8 * data, uint8 max_length);
+
+#ifdef SECURE_LINK_FRAME_POOL
+/*
+ * Description :
+ * Function responsible for receiving one frame like SecureLink_receive, into a frame taken from the pool.
+ * The bytes are written in place as they arrive (from the RX interrupt when RX_INTERRUPT is defined),
+ * the frame is checked and decrypted there, and the payload is never copied.
+ * The caller owns the returned frame and gives it back with FramePool_free.
+ * Return NULL_PTR if the frame is rejected, the pool is empty or the frame doesn't start within
+ * SECURE_LINK_FRAME_TIMEOUT_MS, the frame is dropped then.
+ */
+FramePool_FrameType * SecureLink_receiveFrame(void);
+#endif
+
+#endif /* SECURE_LINK_H_ */
@@ -0,0 +1,177 @@
+/*
+ ============================================================================
+ Name        : sha256.c
+ Author      : Aziza Zamel
+ Description : Source file for the SHA-256 hash
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#include "sha256.h"
+#include "avr/pgmspace.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define ROTR(X,N)		( ((X) >> (N)) | ((X) << (32 - (N))) )
+
+#define SIGMA0(X)		( ROTR(X,2) ^ ROTR(X,13) ^ ROTR(X,22) )
+#define SIGMA1(X)		( ROTR(X,6) ^ ROTR(X,11) ^ ROTR(X,25) )
+#define GAMMA0(X)		( ROTR(X,7) ^ ROTR(X,18) ^ ((X) >> 3) )
+#define GAMMA1(X)		( ROTR(X,17) ^ ROTR(X,19) ^ ((X) >> 10) )
+
+#define CH(X,Y,Z)		( (Z) ^ ((X) & ((Y) ^ (Z))) )
+#define MAJ(X,Y,Z)		( ((X) & (Y)) | ((Z) & ((X) | (Y))) )
+
+/* Message schedule kept in a rolling window of 16 words instead of 64 */
+#define SCHEDULE(J)		( ((J) < 16) ? w[J] : \
+		(w[(J) & 15] += GAMMA1(w[((J) - 2) & 15]) + w[((J) - 7) & 15] + GAMMA0(w[((J) - 15) & 15])) )
+
+/*
+ * One SHA-256 round. The rounds are unrolled by 8 and the working variables are
+ * renamed between calls, so they never have to be shifted in memory.
+ */
+#define SHA256_ROUND(A,B,C,D,E,F,G,H,J) do{ \
+		t1 = (H) + SIGMA1(E) + CH(E,F,G) + pgm_read_dword(&SHA256_K[J]) + SCHEDULE(J); \
+		(D) += t1; \
+		(H) = t1 + SIGMA0(A) + MAJ(A,B,C); \
+	}while(0)
+
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Round constants are kept in flash to save 256 bytes of SRAM */
+static const uint32 SHA256_K[64] PROGMEM = {
+	0x428A2F98UL,0x71374491UL,0xB5C0FBCFUL,0xE9B5DBA5UL,0x3956C25BUL,0x59F111F1UL,0x923F82A4UL,0xAB1C5ED5UL,
+	0xD807AA98UL,0x12835B01UL,0x243185BEUL,0x550C7DC3UL,0x72BE5D74UL,0x80DEB1FEUL,0x9BDC06A7UL,0xC19BF174UL,
+	0xE49B69C1UL,0xEFBE4786UL,0x0FC19DC6UL,0x240CA1CCUL,0x2DE92C6FUL,0x4A7484AAUL,0x5CB0A9DCUL,0x76F988DAUL,
+	0x983E5152UL,0xA831C66DUL,0xB00327C8UL,0xBF597FC7UL,0xC6E00BF3UL,0xD5A79147UL,0x06CA6351UL,0x14292967UL,
+	0x27B70A85UL,0x2E1B2138UL,0x4D2C6DFCUL,0x53380D13UL,0x650A7354UL,0x766A0ABBUL,0x81C2C92EUL,0x92722C85UL,
+	0xA2BFE8A1UL,0xA81A664BUL,0xC24B8B70UL,0xC76C51A3UL,0xD192E819UL,0xD6990624UL,0xF40E3585UL,0x106AA070UL,
+	0x19A4C116UL,0x1E376C08UL,0x2748774CUL,0x34B0BCB5UL,0x391C0CB3UL,0x4ED8AA4AUL,0x5B9CCA4FUL,0x682E6FF3UL,
+	0x748F82EEUL,0x78A5636FUL,0x84C87814UL,0x8CC70208UL,0x90BEFFFAUL,0xA4506CEBUL,0xBEF9A3F7UL,0xC67178F2UL
+};
+
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void SHA256_transform(SHA256_ContextType * Context_Ptr);
+
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for starting a new hash in the given context.
+ */
+void SHA256_init(SHA256_ContextType * Context_Ptr){
+	Context_Ptr->state[0] = 0x6A09E667UL;
+	Context_Ptr->state[1] = 0xBB67AE85UL;
+	Context_Ptr->state[2] = 0x3C6EF372UL;
+	Context_Ptr->state[3] = 0xA54FF53AUL;
+	Context_Ptr->state[4] = 0x510E527FUL;
+	Context_Ptr->state[5] = 0x9B05688CUL;
+	Context_Ptr->state[6] = 0x1F83D9ABUL;
+	Context_Ptr->state[7] = 0x5BE0CD19UL;
+	Context_Ptr->length = 0;
+	Context_Ptr->index = 0;
+}
+
+/*
+ * Description :
+ * Function responsible for adding data to the hash, it can be called many times.
+ */
+void SHA256_update(SHA256_ContextType * Context_Ptr, const uint8 * data, uint16 length){
+	while(length--){
+		Context_Ptr->buffer[Context_Ptr->index++] = *data++;
+		Context_Ptr->length++;
+		if(Context_Ptr->index == SHA256_BLOCK_SIZE){
+			SHA256_transform(Context_Ptr);
+			Context_Ptr->index = 0;
+		}
+	}
+}
+
+/*
+ * Description :
+ * Function responsible for padding the message and writing the 32 bytes digest.
+ */
+void SHA256_final(SHA256_ContextType * Context_Ptr, uint8 * digest){
+	uint32 bit_length = Context_Ptr->length << 3;
+	uint8 i;
+
+	/* Append the 1 bit, then zeros until 8 bytes are left for the length */
+	Context_Ptr->buffer[Context_Ptr->index++] = 0x80;
+	if(Context_Ptr->index > (SHA256_BLOCK_SIZE - 8)){
+		while(Context_Ptr->index < SHA256_BLOCK_SIZE){
+			Context_Ptr->buffer[Context_Ptr->index++] = 0;
+		}
+		SHA256_transform(Context_Ptr);
+		Context_Ptr->index = 0;
+	}
+	while(Context_Ptr->index < (SHA256_BLOCK_SIZE - 4)){
+		Context_Ptr->buffer[Context_Ptr->index++] = 0;
+	}
+
+	/* Big endian message length in bits, the messages here are far below 512 MB */
+	for(i = 0 ; i < 4 ; i++){
+		Context_Ptr->buffer[SHA256_BLOCK_SIZE - 1 - i] = (uint8)(bit_length >> (8*i));
+	}
+	SHA256_transform(Context_Ptr);
+
+	for(i = 0 ; i < SHA256_DIGEST_SIZE ; i++){
+		digest[i] = (uint8)(Context_Ptr->state[i >> 2] >> (24 - 8*(i & 3)));
+	}
+}
+
+/*
+ * Description :
+ * Compress one 64 bytes block into the hash state.
+ */
+static void SHA256_transform(SHA256_ContextType * Context_Ptr){
+	uint32 w[16];
+	uint32 a, b, c, d, e, f, g, h, t1;
+	uint8 i, round;
+
+	for(i = 0 ; i < 16 ; i++){
+		w[i] = ((uint32)Context_Ptr->buffer[4*i] << 24) | ((uint32)Context_Ptr->buffer[4*i+1] << 16)
+				| ((uint32)Context_Ptr->buffer[4*i+2] << 8) | (uint32)Context_Ptr->buffer[4*i+3];
+	}
+
+	a = Context_Ptr->state[0];
+	b = Context_Ptr->state[1];
+	c = Context_Ptr->state[2];
+	d = Context_Ptr->state[3];
+	e = Context_Ptr->state[4];
+	f = Context_Ptr->state[5];
+	g = Context_Ptr->state[6];
+	h = Context_Ptr->state[7];
+
+	for(round = 0 ; round < 64 ; round += 8){
+		SHA256_ROUND(a,b,c,d,e,f,g,h,round);
+		SHA256_ROUND(h,a,b,c,d,e,f,g,round+1);
+		SHA256_ROUND(g,h,a,b,c,d,e,f,round+2);
+		SHA256_ROUND(f,g,h,a,b,c,d,e,round+3);
+		SHA256_ROUND(e,f,g,h,a,b,c,d,round+4);
+		SHA256_ROUND(d,e,f,g,h,a,b,c,round+5);
+		SHA256_ROUND(c,d,e,f,g,h,a,b,round+6);
+		SHA256_ROUND(b,c,d,e,f,g,h,a,round+7);
+	}
+
+	Context_Ptr->state[0] += a;
+	Context_Ptr->state[1] += b;
+	Context_Ptr->state[2] += c;
+	Context_Ptr->state[3] += d;
+	Context_Ptr->state[4] += e;
+	Context_Ptr->state[5] += f;
+	Context_Ptr->state[6] += g;
+	Context_Ptr->state[7] += h;
+}
@@ -0,0 +1,58 @@
+/*
+ ============================================================================
+ Name        : sha256.h
+ Author      : Aziza Zamel
+ Description : Header file for the SHA-256 hash
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef SHA256_H_
+#define SHA256_H_
+
+#include "std_types.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SHA256_BLOCK_SIZE		64
+#define SHA256_DIGEST_SIZE		32
+
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct{
+	uint32 state[8];
+	uint8 buffer[SHA256_BLOCK_SIZE];
+	uint32 length;		/* Total message length in bytes */
+	uint8 index;		/* Number of bytes waiting in the buffer */
+}SHA256_ContextType;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for starting a new hash in the given context.
+ */
+void SHA256_init(SHA256_ContextType * Context_Ptr);
+
+/*
+ * Description :
+ * Function responsible for adding data to the hash, it can be called many times.
+ */
+void SHA256_update(SHA256_ContextType * Context_Ptr, const uint8 * data, uint16 length);
+
+/*
+ * Description :
+ * Function responsible for padding the message and writing the 32 bytes digest.
+ */
+void SHA256_final(SHA256_ContextType * Context_Ptr, uint8 * digest);
+
+#endif /* SHA256_H_ */
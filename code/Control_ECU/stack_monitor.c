@@ -0,0 +1,97 @@
+/*
+ ============================================================================
+ Name        : stack_monitor.c
+ Author      : Aziza Zamel
+ Description : Source file for the stack painting and RAM usage report
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#include "stack_monitor.h"
+#include "uart.h"
+
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Linker symbols : start of .data, end of .bss and top of the RAM */
+extern uint8 __data_start;
+extern uint8 _end;
+extern uint8 __stack;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+void StackMonitor_paint(void) __attribute__((naked, used, section(".init1")));
+static void StackMonitor_sendWord(uint16 value);
+
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Paint the RAM from _end to __stack before the C run time is set up, it is called by the start up code
+ * from the .init1 section. It is written in assembly because r1 isn't cleared yet and there is no stack frame.
+ */
+void StackMonitor_paint(void){
+	__asm__ volatile(
+		"	ldi r30, lo8(_end)		\n"
+		"	ldi r31, hi8(_end)		\n"
+		"	ldi r24, %0				\n"
+		"	ldi r25, hi8(__stack)	\n"
+		"	rjmp 2f					\n"
+		"1:	st Z+, r24				\n"
+		"2:	cpi r30, lo8(__stack)	\n"
+		"	cpc r31, r25			\n"
+		"	brlo 1b					\n"
+		"	breq 1b					\n"
+		: : "M" (STACK_MONITOR_PAINT));
+}
+
+/*
+ * Description :
+ * Function responsible for returning the size of the static variables (.data and .bss) in bytes.
+ */
+uint16 StackMonitor_getStaticSize(void){
+	return (uint16)(&_end - &__data_start);
+}
+
+/*
+ * Description :
+ * Function responsible for returning the number of bytes the stack never reached since reset.
+ * The stack grows down from __stack, so the painted bytes left are found from _end upwards.
+ */
+uint16 StackMonitor_getUnused(void){
+	const uint8 * byte_ptr = &_end;
+	uint16 unused = 0;
+
+	while((byte_ptr <= &__stack) && (*byte_ptr == STACK_MONITOR_PAINT)){
+		byte_ptr++;
+		unused++;
+	}
+	return unused;
+}
+
+/*
+ * Description :
+ * Function responsible for sending the static size, the stack headroom and the RAM size through UART.
+ */
+void StackMonitor_report(void){
+	StackMonitor_sendWord(StackMonitor_getStaticSize());
+	StackMonitor_sendWord(StackMonitor_getUnused());
+	StackMonitor_sendWord((uint16)(&__stack - &__data_start) + 1);
+}
+
+/*
+ * Description :
+ * Send the value through UART, high byte first.
+ */
+static void StackMonitor_sendWord(uint16 value){
+	UART_sendByte((uint8)(value >> 8));
+	UART_sendByte((uint8)value);
+}
@@ -0,0 +1,50 @@
+/*
+ ============================================================================
+ Name        : stack_monitor.h
+ Author      : Aziza Zamel
+ Description : Header file for the stack painting and RAM usage report
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef STACK_MONITOR_H_
+#define STACK_MONITOR_H_
+
+#include "std_types.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * The RAM between the end of the static variables and the top of the stack is painted with this
+ * value before main, the stack never reached the bytes that still hold it. The heap is not used.
+ */
+#define STACK_MONITOR_PAINT		0xC5
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for returning the size of the static variables (.data and .bss) in bytes.
+ */
+uint16 StackMonitor_getStaticSize(void);
+
+/*
+ * Description :
+ * Function responsible for returning the number of bytes the stack never reached since reset (the headroom).
+ */
+uint16 StackMonitor_getUnused(void);
+
+/*
+ * Description :
+ * Function responsible for sending the static size, the stack headroom and the RAM size through UART,
+ * 2 bytes each, high byte first.
+ */
+void StackMonitor_report(void);
+
+#endif /* STACK_MONITOR_H_ */
@@ -16,55 +16,47 @@
  *                           Global Variables                                  *
  *******************************************************************************/
 
-/* Global variables to hold the address of the call back functions in the application */
-static volatile void (*g_timer0CallBackPtr)(void) = NULL_PTR;
-static volatile void (*g_timer1CallBackPtr)(void) = NULL_PTR;
-static volatile void (*g_timer2CallBackPtr)(void) = NULL_PTR;
+/* Call back functions of each timer and their contexts, an empty entry has a NULL_PTR call back */
+static volatile Timer_SubscriberType g_subscribers[3][TIMER_MAX_SUBSCRIBERS];
+
+/* Owner of each timer, indexed by Timer_ID_Type */
+static Timer_UserType g_timerOwners[3] = {TIMER_USER_NONE,TIMER_USER_NONE,TIMER_USER_NONE};
+
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void Timer_dispatch(Timer_ID_Type timer_ID);
+static void Timer_clearSubscribers(Timer_ID_Type timer_ID);
+
 
 /*******************************************************************************
  *                       Interrupt Service Routines                            *
  *******************************************************************************/
 
 ISR(TIMER0_OVF_vect){
-	if(g_timer0CallBackPtr != NULL_PTR){
-		/* Call the Call Back function */
-		(*g_timer0CallBackPtr)();
-	}
+	Timer_dispatch(TIMER0_ID);
 }
 
 ISR(TIMER0_COMP_vect){
-	if (g_timer0CallBackPtr != NULL_PTR) {
-		/* Call the Call Back function */
-		(*g_timer0CallBackPtr)();
-	}
+	Timer_dispatch(TIMER0_ID);
 }
 
 ISR(TIMER1_OVF_vect){
-	if(g_timer1CallBackPtr != NULL_PTR){
-		/* Call the Call Back function */
-		(*g_timer1CallBackPtr)();
-	}
+	Timer_dispatch(TIMER1_ID);
 }
 
 ISR(TIMER1_COMPA_vect){
-	if(g_timer1CallBackPtr != NULL_PTR){
-		/* Call the Call Back function */
-		(*g_timer1CallBackPtr)();
-	}
+	Timer_dispatch(TIMER1_ID);
 }
 
 ISR(TIMER2_OVF_vect){
-	if(g_timer2CallBackPtr != NULL_PTR){
-		/* Call the Call Back function */
-		(*g_timer2CallBackPtr)();
-	}
+	Timer_dispatch(TIMER2_ID);
 }
 
 ISR(TIMER2_COMP_vect){
-	if(g_timer2CallBackPtr != NULL_PTR){
-		/* Call the Call Back function */
-		(*g_timer2CallBackPtr)();
-	}
+	Timer_dispatch(TIMER2_ID);
 }
 
 
@@ -79,8 +71,13 @@ ISR(TIMER2_COMP_vect){
  * 2. Setup Timer compare value in case of compare mode.
  * 3. Set the required clock.
  * 4. Enable Overflow Interrupt or Compare Match Interrupt
+ * Return FALSE without touching the timer if the user doesn't own it, see Timer_claim.
  */
-void Timer_init(const Timer_ConfigType * Config_Ptr){
+boolean Timer_init(const Timer_ConfigType * Config_Ptr, Timer_UserType user){
+	if((Config_Ptr->timer_ID > TIMER2_ID) || (user == TIMER_USER_NONE) || (g_timerOwners[Config_Ptr->timer_ID] != user)){
+		return FALSE;
+	}
+
 	switch(Config_Ptr->timer_ID){
 	case TIMER0_ID:
 		/* Set Timer0 initial count */
@@ -178,13 +175,19 @@ void Timer_init(const Timer_ConfigType * Config_Ptr){
 		/* Select the required clock */
 		TCCR2_REG.bits.CS2_bits = Config_Ptr->timer_clock;
 	}
+	return TRUE;
 }
 
 
 /*
  * Description:  Function to disable the Timer via Timer_ID.
+ * Only the owner of the timer can disable it, so a driver can't stop a timer that was given to another one.
  */
-void Timer_deInit(Timer_ID_Type timer_type){
+void Timer_deInit(Timer_ID_Type timer_type, Timer_UserType user){
+	if((timer_type > TIMER2_ID) || (user == TIMER_USER_NONE) || (g_timerOwners[timer_type] != user)){
+		return;
+	}
+
 	switch(timer_type){
 	case TIMER0_ID:
 
@@ -196,9 +199,6 @@ void Timer_deInit(Timer_ID_Type timer_type){
 		/* Disable Timer0 interrupt */
 		TIMSK_REG.Bits.OCIE0_bit = LOGIC_LOW;
 		TIMSK_REG.Bits.TOIE0_bit = LOGIC_LOW;
-
-		/* Reset the global pointer value */
-		g_timer0CallBackPtr = NULL_PTR;
 		break;
 	case TIMER1_ID:
 
@@ -211,9 +211,6 @@ void Timer_deInit(Timer_ID_Type timer_type){
 		/* Disable Timer1 interrupt */
 		TIMSK_REG.Bits.OCIE1A_bit = LOGIC_LOW;
 		TIMSK_REG.Bits.TOIE1_bit = LOGIC_LOW;
-
-		/* Reset the global pointer value */
-		g_timer1CallBackPtr = NULL_PTR;
 		break;
 	case TIMER2_ID:
 
@@ -225,52 +222,122 @@ void Timer_deInit(Timer_ID_Type timer_type){
 		/* Disable Timer2 interrupt */
 		TIMSK_REG.Bits.OCIE2_bit = LOGIC_LOW;
 		TIMSK_REG.Bits.TOIE2_bit = LOGIC_LOW;
-
-		/* Reset the global pointer value */
-		g_timer2CallBackPtr = NULL_PTR;
 	}
+
+	/* Remove the call back functions */
+	Timer_clearSubscribers(timer_type);
 }
 
 
 /*
- * Description: Function to set the Call Back function address to the required Timer.
+ * Description :
+ * Function responsible for adding a call back function to the timer, it is called with the context on every interrupt.
+ * It is safe to call while the timer interrupt is enabled. Return FALSE if the timer has no free entry.
  */
-void Timer_setCallBack(void(*a_ptr)(void), Timer_ID_Type a_timer_ID ){
-	/* Save the address of the Call back function in a global variable */
-	switch(a_timer_ID){
-	case TIMER0_ID:
-		g_timer0CallBackPtr = a_ptr;
-		break;
-	case TIMER1_ID:
-		g_timer1CallBackPtr = a_ptr;
-		break;
-	case TIMER2_ID:
-		g_timer2CallBackPtr = a_ptr;
-	}
-}
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+boolean Timer_subscribe(Timer_ID_Type timer_ID, Timer_CallBackType callback, void * context){
+	uint8 interrupts = SREG_REG.bits.I_bit;
+	boolean added = FALSE;
+	uint8 i;
 
+	if((timer_ID > TIMER2_ID) || (callback == NULL_PTR)){
+		return FALSE;
+	}
 
+	/* The interrupt must never see an entry with the call back of one subscriber and the context of another */
+	SREG_REG.bits.I_bit = LOGIC_LOW;
+	for(i = 0 ; i < TIMER_MAX_SUBSCRIBERS ; i++){
+		if(g_subscribers[timer_ID][i].callback == NULL_PTR){
+			g_subscribers[timer_ID][i].context = context;
+			g_subscribers[timer_ID][i].callback = callback;
+			added = TRUE;
+			break;
+		}
+	}
+	SREG_REG.bits.I_bit = interrupts;
+	return added;
+}
 
+/*
+ * Description :
+ * Function responsible for removing the call back function with the context from the timer.
+ */
+void Timer_unsubscribe(Timer_ID_Type timer_ID, Timer_CallBackType callback, void * context){
+	uint8 interrupts = SREG_REG.bits.I_bit;
+	uint8 i;
 
+	if(timer_ID > TIMER2_ID){
+		return;
+	}
 
+	SREG_REG.bits.I_bit = LOGIC_LOW;
+	for(i = 0 ; i < TIMER_MAX_SUBSCRIBERS ; i++){
+		if((g_subscribers[timer_ID][i].callback == callback) && (g_subscribers[timer_ID][i].context == context)){
+			g_subscribers[timer_ID][i].callback = NULL_PTR;
+		}
+	}
+	SREG_REG.bits.I_bit = interrupts;
+}
 
+/*
+ * Description :
+ * Function responsible for giving the timer to the user before it configures the timer.
+ * Return FALSE if another user owns the timer, claiming a timer the user already owns succeeds.
+ */
+boolean Timer_claim(Timer_ID_Type timer_ID, Timer_UserType user){
+	if((timer_ID > TIMER2_ID) || (user == TIMER_USER_NONE)){
+		return FALSE;
+	}
+	if((g_timerOwners[timer_ID] != TIMER_USER_NONE) && (g_timerOwners[timer_ID] != user)){
+		return FALSE;
+	}
+	g_timerOwners[timer_ID] = user;
+	return TRUE;
+}
 
+/*
+ * Description :
+ * Function responsible for stopping the timer and freeing it, only if the user owns it,
+ * so a driver can't stop a timer that was given to another one.
+ */
+void Timer_release(Timer_ID_Type timer_ID, Timer_UserType user){
+	if((timer_ID > TIMER2_ID) || (user == TIMER_USER_NONE) || (g_timerOwners[timer_ID] != user)){
+		return;
+	}
+	Timer_deInit(timer_ID,user);
+	g_timerOwners[timer_ID] = TIMER_USER_NONE;
+}
 
+/*
+ * Description :
+ * Call the call back functions of the timer, in the order they were added.
+ */
+static void Timer_dispatch(Timer_ID_Type timer_ID){
+	Timer_CallBackType callback;
+	uint8 i;
+
+	for(i = 0 ; i < TIMER_MAX_SUBSCRIBERS ; i++){
+		callback = g_subscribers[timer_ID][i].callback;
+		if(callback != NULL_PTR){
+			callback(g_subscribers[timer_ID][i].context);
+		}
+	}
+}
 
+/*
+ * Description :
+ * Remove all the call back functions of the timer.
+ */
+static void Timer_clearSubscribers(Timer_ID_Type timer_ID){
+	uint8 interrupts = SREG_REG.bits.I_bit;
+	uint8 i;
 
+	if(timer_ID > TIMER2_ID){
+		return;
+	}
 
+	SREG_REG.bits.I_bit = LOGIC_LOW;
+	for(i = 0 ; i < TIMER_MAX_SUBSCRIBERS ; i++){
+		g_subscribers[timer_ID][i].callback = NULL_PTR;
+	}
+	SREG_REG.bits.I_bit = interrupts;
+}
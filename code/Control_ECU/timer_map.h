@@ -0,0 +1,35 @@
+/*
+ ============================================================================
+ Name        : timer_map.h
+ Author      : Aziza Zamel
+ Description : Hardware timers used by each driver of Control_ECU
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef TIMER_MAP_H_
+#define TIMER_MAP_H_
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Values of the timer ids for the preprocessor, same as Timer_ID_Type */
+#define TIMER_MAP_TIMER0		0
+#define TIMER_MAP_TIMER1		1
+#define TIMER_MAP_TIMER2		2
+
+/*
+ * Every driver that needs a hardware timer takes it from here, and claims it with Timer_claim at init.
+ * The 1 ms tick of the RTC is the only system tick, the other software timing reads RTC_getMilliseconds.
+ */
+#define TIMER_MAP_TICK			TIMER_MAP_TIMER2		/* RTC 1 ms tick */
+#define TIMER_MAP_PWM			TIMER_MAP_TIMER0		/* motor speed, OC0 is the only PWM pin wired */
+#define TIMER_MAP_PROBE			TIMER_MAP_TIMER1		/* 1 us free running counter of the execution time probes */
+
+#if (TIMER_MAP_TICK == TIMER_MAP_PWM) || (TIMER_MAP_TICK == TIMER_MAP_PROBE) || (TIMER_MAP_PWM == TIMER_MAP_PROBE)
+#error "Two drivers are given the same timer"
+#endif
+
+#endif /* TIMER_MAP_H_ */
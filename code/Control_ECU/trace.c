@@ -0,0 +1,72 @@
+/*
+ ============================================================================
+ Name        : trace.c
+ Author      : Aziza Zamel
+ Description : Source file for the RAM trace of the external inputs
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#include "trace.h"
+#include "rtc.h"
+#include "uart.h"
+
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static uint8 g_records[TRACE_MAX_RECORDS][TRACE_RECORD_SIZE];
+
+/* Index of the next record to write and number of records in the ring */
+static uint8 g_head = 0;
+static uint8 g_count = 0;
+
+/* Time of the newest record */
+static uint32 g_lastTime = 0;
+
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for adding a record after the newest one, overwriting the oldest when the trace is full.
+ */
+void Trace_record(Trace_EventType event, uint8 data){
+	uint32 now = RTC_getMilliseconds();
+	uint32 delta = now - g_lastTime;
+
+	if(delta > TRACE_MAX_DELTA){
+		delta = TRACE_MAX_DELTA;
+	}
+	g_lastTime = now;
+
+	g_records[g_head][0] = (uint8)(delta >> 8);
+	g_records[g_head][1] = (uint8)delta;
+	g_records[g_head][2] = (uint8)event;
+	g_records[g_head][3] = data;
+
+	g_head = (g_head + 1) % TRACE_MAX_RECORDS;
+	if(g_count < TRACE_MAX_RECORDS){
+		g_count++;
+	}
+}
+
+/*
+ * Description :
+ * Function responsible for sending the number of records then all the records, oldest first, through UART.
+ */
+void Trace_dump(void){
+	uint8 index, remaining, i;
+
+	UART_sendByte(g_count);
+	index = (g_count == TRACE_MAX_RECORDS) ? g_head : 0;
+	for(remaining = g_count ; remaining != 0 ; remaining--){
+		for(i = 0 ; i < TRACE_RECORD_SIZE ; i++){
+			UART_sendByte(g_records[index][i]);
+		}
+		index = (index + 1) % TRACE_MAX_RECORDS;
+	}
+}
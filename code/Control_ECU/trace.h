@@ -0,0 +1,62 @@
+/*
+ ============================================================================
+ Name        : trace.h
+ Author      : Aziza Zamel
+ Description : Header file for the RAM trace of the external inputs
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include "std_types.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * The trace is a RAM ring of the last external inputs, to rebuild the order of the events of a field unit.
+ * Record : milliseconds since the previous record (2 bytes, big endian, 0xFFFF = longer) | event | data
+ * Passwords are never traced, a frame is traced by its length only.
+ */
+#define TRACE_RECORD_SIZE		4
+#define TRACE_MAX_RECORDS		32
+
+/* Delta saved for gaps of 65.535 s or more */
+#define TRACE_MAX_DELTA			0xFFFF
+
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef enum{
+	TRACE_EVENT_BOOT,				/* data : 0 */
+	TRACE_EVENT_COMMAND,			/* data : command byte received from HMI_ECU */
+	TRACE_EVENT_FRAME,				/* data : length of the secure link frame, 0 if it was rejected */
+	TRACE_EVENT_PIR,				/* data : new state of the PIR sensor */
+	TRACE_EVENT_MOTOR,				/* data : new DcMotor_State */
+	TRACE_EVENT_LOCKOUT_END			/* data : 0 */
+}Trace_EventType;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for adding a record after the newest one, overwriting the oldest when the trace is full.
+ */
+void Trace_record(Trace_EventType event, uint8 data);
+
+/*
+ * Description :
+ * Function responsible for sending the number of records then all the records, oldest first, through UART.
+ */
+void Trace_dump(void);
+
+#endif /* TRACE_H_ */
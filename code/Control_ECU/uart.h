@@ -12,11 +12,12 @@
 
 #include "std_types.h"
 
-//#define RX_INTERRUPT
+/* Receive the bytes from the RX complete interrupt into a queue, so they can wake up the CPU from idle sleep */
+#define RX_INTERRUPT
 
 #ifdef RX_INTERRUPT
-extern volatile uint8 g_uartRecievedByte;
-extern volatile boolean g_uartRecieveFlag;
+/* Bytes the RX complete interrupt can hold until they are read, a power of two up to 128 */
+#define UART_RX_QUEUE_SIZE				16
 #endif
 /*******************************************************************************
  *                         Types Declaration                                   *
@@ -51,7 +52,28 @@ typedef struct
 	UART_BaudRateType baud_rate;
 }UART_ConfigType;
 
+#ifdef RX_INTERRUPT
+/* Called from the RX complete interrupt with each received byte, return FALSE after the last byte it needs */
+typedef boolean (*UART_RxHookType)(uint8 data, void * context);
+#endif
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Maximum accepted baud rate error in per-mille (20 = 2%) */
+#define UART_MAX_BAUD_ERROR_PERMILLE	20
+
+/* Largest value that fits in the 12-bit UBRR register */
+#define UART_MAX_UBRR_VALUE				4095
+
+/* Baud rate both ECUs start with before the speed negotiation */
+#define UART_BASE_BAUD_RATE				9600
 
+/* Candidate baud rates for the speed negotiation, fastest first, the last one must be the base rate */
+#define UART_NEGOTIATION_BAUD_RATES		{115200,76800,57600,38400,19200,UART_BASE_BAUD_RATE}
+#define UART_NUM_OF_NEGOTIATION_RATES	6
 
 
 /*******************************************************************************
@@ -64,8 +86,29 @@ typedef struct
  * 1. Setup the Frame format like number of data bits, parity bit type and number of stop bits.
  * 2. Enable the UART.
  * 3. Setup the UART baud rate.
+ * Return FALSE if the baud rate can't be generated from F_CPU within UART_MAX_BAUD_ERROR_PERMILLE.
  */
-void UART_init(const UART_ConfigType * Config_Ptr);
+boolean UART_init(const UART_ConfigType * Config_Ptr);
+
+/*
+ * Description :
+ * Function responsible for finding the U2X/UBRR combination with the lowest baud rate error for F_CPU.
+ * Return FALSE if the best combination error is above UART_MAX_BAUD_ERROR_PERMILLE.
+ */
+boolean UART_calculateBaudRate(UART_BaudRateType baud_rate, uint16 * ubrr_ptr, boolean * u2x_ptr);
+
+/*
+ * Description :
+ * Function responsible for changing the UART baud rate at run time.
+ * Return FALSE and keep the current baud rate if the required one is not supported.
+ */
+boolean UART_setBaudRate(UART_BaudRateType baud_rate);
+
+/*
+ * Description :
+ * Function responsible for waiting until all the sent bytes left the transmit shift register.
+ */
+void UART_flush(void);
 
 /*
  * Description :
@@ -79,6 +122,19 @@ void UART_sendByte(const uint8 data);
  */
 uint8 UART_recieveByte(void);
 
+/*
+ * Description :
+ * Function responsible for checking if a received byte is waiting, without blocking.
+ */
+boolean UART_isByteReceived(void);
+
+/*
+ * Description :
+ * Function responsible for receive byte from another UART device, waiting at most timeout_ms milliseconds.
+ * Return FALSE if no byte was received in time.
+ */
+boolean UART_receiveByteTimeout(uint8 *data_ptr, uint16 timeout_ms);
+
 /*
  * Description :
  * Send the required string through UART to the other UART device.
@@ -88,7 +144,17 @@ void UART_sendString(const uint8 *Str);
 /*
  * Description :
  * Receive the required string until the '#' symbol through UART from the other UART device.
+ * At most max_length - 1 characters are stored, the rest is dropped. Return the number of characters stored.
+ */
+uint8 UART_receiveString(uint8 *Str, uint8 max_length); // Receive until #
+
+#ifdef RX_INTERRUPT
+/*
+ * Description :
+ * Function responsible for giving the received bytes to the hook instead of the RX queue, until it returns FALSE.
+ * The bytes already waiting in the queue are given first. NULL_PTR removes the hook.
  */
-void UART_receiveString(uint8 *Str); // Receive until #
+void UART_setRxHook(UART_RxHookType hook, void * context);
+#endif
 
 #endif /* UART_H_ */
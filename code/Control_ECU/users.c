@@ -0,0 +1,110 @@
+/*
+ ============================================================================
+ Name        : users.c
+ Author      : Aziza Zamel
+ Description : Source file for the multi-user credential table
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#include "users.h"
+#include "external_eeprom.h"
+#include "common_macros.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define USERS_RECORD_ADDRESS(SLOT)	(USERS_TABLE_ADDRESS + ((uint16)(SLOT) * PASSWORD_RECORD_SIZE))
+
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* One bit per slot, set if the slot holds an active user */
+static uint8 g_usersActive[(USERS_MAX_COUNT + 7) / 8];
+
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for building the RAM index of the active slots by reading every record status once.
+ */
+void Users_init(void){
+	uint8 slot, status;
+
+	for(slot = 0 ; slot < USERS_MAX_COUNT ; slot++){
+		if((EEPROM_readByte(USERS_RECORD_ADDRESS(slot), &status) == SUCCESS) && (status == PASSWORD_RECORD_VALID)){
+			SET_BIT(g_usersActive[slot >> 3], (slot & 7));
+		}else{
+			CLEAR_BIT(g_usersActive[slot >> 3], (slot & 7));
+		}
+	}
+}
+
+/*
+ * Description :
+ * Function responsible for checking if the slot holds an active user, without accessing the EEPROM.
+ */
+boolean Users_isActive(uint8 slot){
+	if(slot >= USERS_MAX_COUNT){
+		return FALSE;
+	}
+	return GET_BIT(g_usersActive[slot >> 3], (slot & 7));
+}
+
+/*
+ * Description :
+ * Function responsible for saving the password of the user in the slot and activating it.
+ * Return SUCCESS or ERROR.
+ */
+uint8 Users_enroll(uint8 slot, const uint8 * password, uint8 length){
+	if(slot >= USERS_MAX_COUNT){
+		return ERROR;
+	}
+	if(Password_save(USERS_RECORD_ADDRESS(slot), password, length) != SUCCESS){
+		return ERROR;
+	}
+	SET_BIT(g_usersActive[slot >> 3], (slot & 7));
+	return SUCCESS;
+}
+
+/*
+ * Description :
+ * Function responsible for revoking the user in the slot.
+ * Return SUCCESS or ERROR.
+ */
+uint8 Users_revoke(uint8 slot){
+	if(slot >= USERS_MAX_COUNT){
+		return ERROR;
+	}
+	/* Refuse new logins right away, even if the EEPROM write fails */
+	CLEAR_BIT(g_usersActive[slot >> 3], (slot & 7));
+	return EEPROM_writeByte(USERS_RECORD_ADDRESS(slot), USERS_RECORD_REVOKED);
+}
+
+/*
+ * Description :
+ * Function responsible for checking the password of the user in the slot.
+ * Inactive slots are rejected from the RAM index, only active ones read their record from EEPROM.
+ */
+boolean Users_verify(uint8 slot, const uint8 * password, uint8 length){
+	if(!Users_isActive(slot)){
+		return FALSE;
+	}
+	return Password_verify(USERS_RECORD_ADDRESS(slot), password, length);
+}
+
+/*
+ * Description :
+ * Function responsible for starting the check of the password of the user in the slot before its digits arrive,
+ * the record is read now. Inactive slots don't read the EEPROM and always fail.
+ */
+void Users_beginVerify(uint8 slot, Password_VerifierType * Verifier_Ptr){
+	Password_beginVerify(Verifier_Ptr, Users_isActive(slot) ? USERS_RECORD_ADDRESS(slot) : PASSWORD_NO_ADDRESS);
+}
@@ -0,0 +1,79 @@
+/*
+ ============================================================================
+ Name        : users.h
+ Author      : Aziza Zamel
+ Description : Header file for the multi-user credential table
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef USERS_H_
+#define USERS_H_
+
+#include "std_types.h"
+#include "password.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * One password record per user slot, slot N is at USERS_TABLE_ADDRESS + N * PASSWORD_RECORD_SIZE.
+ * 64 slots of 16 bytes fill the upper half of the 24C16 (0x0400 - 0x07FF).
+ */
+#define USERS_TABLE_ADDRESS		0x0400
+#define USERS_MAX_COUNT			64
+
+/* Slot 0 holds the system password created at start up, only this user can enroll or revoke others */
+#define USERS_ADMIN_SLOT		0
+
+/* Status written in a record to revoke its user */
+#define USERS_RECORD_REVOKED	0x00
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for building the RAM index of the active slots by reading every record status once.
+ */
+void Users_init(void);
+
+/*
+ * Description :
+ * Function responsible for checking if the slot holds an active user, without accessing the EEPROM.
+ */
+boolean Users_isActive(uint8 slot);
+
+/*
+ * Description :
+ * Function responsible for saving the password of the user in the slot and activating it.
+ * Return SUCCESS or ERROR.
+ */
+uint8 Users_enroll(uint8 slot, const uint8 * password, uint8 length);
+
+/*
+ * Description :
+ * Function responsible for revoking the user in the slot.
+ * Return SUCCESS or ERROR.
+ */
+uint8 Users_revoke(uint8 slot);
+
+/*
+ * Description :
+ * Function responsible for checking the password of the user in the slot.
+ * Inactive slots are rejected from the RAM index, only active ones read their record from EEPROM.
+ */
+boolean Users_verify(uint8 slot, const uint8 * password, uint8 length);
+
+/*
+ * Description :
+ * Function responsible for starting the check of the password of the user in the slot before its digits arrive,
+ * the record is read now. Continue with Password_updateVerify and Password_endVerify.
+ */
+void Users_beginVerify(uint8 slot, Password_VerifierType * Verifier_Ptr);
+
+#endif /* USERS_H_ */
@@ -40,6 +40,8 @@
 /***********************************************************************************************/
 
 #define SREG_REG     (*(volatile SREG_Type * const)0x5F)
+#define MCUCR_REG    (*(volatile MCU_MCUCR_Type * const)0x55)
+#define GICR_REG     (*(volatile MCU_GICR_Type * const)0x5B)
 
 /***********************************************************************************************/
 
@@ -110,6 +112,7 @@
 #define TWEA_BIT_POSITION 6
 #define TWINT_BIT_POSITION 7
 
+#define U2X_BIT_POSITION   1
 
 #define UCSZ0_BIT_POSITION 1
 #define USBS_BIT_POSITION  3
@@ -30,6 +30,34 @@ typedef union {
 } SREG_Type;
 
 
+/************************* MCU Control Registers type structure declarations ************************/
+
+typedef union {
+	uint8 Byte;
+	struct{
+		uint8 ISC00_bit:1;
+		uint8 ISC01_bit:1;
+		uint8 ISC10_bit:1;
+		uint8 ISC11_bit:1;
+		uint8 SM_bits:3;
+		uint8 SE_bit:1;
+	}Bits;
+}MCU_MCUCR_Type;
+
+
+typedef union {
+	uint8 Byte;
+	struct{
+		uint8 IVCE_bit:1;
+		uint8 IVSEL_bit:1;
+		uint8 :3;
+		uint8 INT2_bit:1;
+		uint8 INT0_bit:1;
+		uint8 INT1_bit:1;
+	}Bits;
+}MCU_GICR_Type;
+
+
 /************************* GPIO type structure declarations ************************/
 
 typedef union {
@@ -12,14 +12,20 @@
 #include "std_types.h"
 #include "util/delay.h"
 #include "uart.h"
+#include "secure_link.h"
 #include "timer.h"
+#include "power.h"
+#include "timer_map.h"
+#include "avr/pgmspace.h"
 
 
 /*******************************************************************************
  *                                Definitions                                  *
  *******************************************************************************/
 
-#define PASSWORD_SIZE 				5
+/* PINs are 4 to 12 digits ended by '=', their length is carried by the secure link frame */
+#define PASSWORD_MIN_SIZE			4
+#define PASSWORD_MAX_SIZE			12
 #define PASSWORD_SAVED 				0x11
 #define DIFF_PASSWORDS				0x22
 #define TRUE_PASSWORD				0x33
@@ -29,28 +35,109 @@
 #define UNLOCK_DOOR    				0x55
 #define ALARM_MODE					0x53
 #define CHANGE_PASSWORD				0xE3
+#define BAUD_REQUEST				0x66
+#define BAUD_ACCEPTED				0x67
+#define BAUD_REJECTED				0x68
+#define ENROLL_USER					0x71
+#define REVOKE_USER					0x72
+#define ACCESS_GRANTED				0x73
+#define ACCESS_DENIED				0x74
+#define USER_SLOT_OK				0x75
+#define USER_SLOT_INVALID			0x76
+#define LOGIN_REQUEST				0x81
+#define LOCKOUT_STATUS				0x82
+#define HEARTBEAT					0x83
+#define HEARTBEAT_ACK				0x84
+#define SYSTEM_SETUP				0x85
+#define SETUP_REQUIRED				0x86
+#define SETUP_DONE					0x87
+#define AUDIT_DUMP					0x88
+#define SET_TIME					0x89
+#define TIME_ACCEPTED				0x8A
+#define TIME_INVALID				0x8B
+#define GET_TIME					0x8C
+#define SCHEDULE_EDIT				0x8D
+#define SCHEDULE_OK					0x8E
+#define SCHEDULE_INVALID			0x8F
+#define OUT_OF_SCHEDULE				0x90
+#define CONFIG_READ					0x91
+#define CONFIG_EDIT					0x92
+#define DOOR_UNLOCKED				0x93
+#define DOOR_LOCKED					0x94
+#define CONFIG_OK					0x95
+#define CONFIG_INVALID				0x96
+#define TRACE_DUMP					0x97
+#define PROBE_DUMP					0x98
+#define RAM_REPORT					0x99
+#define PASSWORD_NOT_SAVED			0x9C
+#define LOGIN_ABORTED				0x9D
+
+/* User slots are entered as 2 digits, slot 00 is the admin */
+#define USER_ID_DIGITS				2
+
+/* The date and time are entered as YYMMDDhhmm, each field is 2 digits */
+#define TIME_FIELD_DIGITS			2
+#define TIME_FIELDS					5
+#define TIME_FRAME_SIZE				6
 
-/*******************************************************************************
- *                           Global Variables                                  *
- *******************************************************************************/
-
-volatile uint8 tick = 0;
-volatile boolean t_15s_flag = FALSE;
-volatile boolean t_60s_flag = FALSE;
-volatile boolean alarm_flag = FALSE;
-/* Create configuration structure for timer driver */
-Timer_ConfigType timerConfig = {0,39062,TIMER1_ID,F_CPU_1024,COMPARE_MODE};
-
+/*
+ * schedule frame : operation | 7 parameters
+ * rule   : profile | first day | last day | start hour | start minute | end hour | end minute
+ * clear  : profile
+ * assign : user slot | profile
+ */
+#define SCHEDULE_FRAME_SIZE			8
+#define SCHEDULE_OP_RULE			0
+#define SCHEDULE_OP_CLEAR			1
+#define SCHEDULE_OP_ASSIGN			2
+/* Profile digit entered to remove the time restrictions of a user */
+#define NO_PROFILE_DIGIT			9
+#define SCHEDULE_NO_PROFILE			0xFF
+
+/* configuration frame : field | value (2 bytes, big endian), the values have up to 3 digits */
+#define CONFIG_FRAME_SIZE			3
+#define CONFIG_FIELD_DIGITS			1
+#define CONFIG_VALUE_DIGITS			3
+
+/* Longest wait for HEARTBEAT_ACK before a new exchange or CONTROL_ECU_READY after a PIN digit,
+ * and for a proposed baud rate after BAUD_REQUEST */
+#define LINK_CHECK_TIMEOUT_MS		50
+#define BAUD_LISTEN_TIMEOUT_MS		250
+
+/* a new password frame must fit in one secure link frame */
+#if (PASSWORD_MAX_SIZE > SECURE_LINK_MAX_PAYLOAD)
+#error "PASSWORD_MAX_SIZE doesn't fit in a secure link frame"
+#endif
+
+/* receiveByte sleeps until the RX interrupt, polling UDR a reply couldn't be longer than the 3 bytes UART buffer */
+#ifndef RX_INTERRUPT
+#error "RX_INTERRUPT must be defined in uart.h"
+#endif
+
+/* The wake up tick uses the prescalers of Timer0 and Timer1 */
+#if (TIMER_MAP_TICK == TIMER_MAP_TIMER2)
+#error "The wake up tick can't use Timer2"
+#endif
 
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
 
-void createPassword(void);
-void getPassword(uint8 * pass, uint8 size);
+boolean createPassword(void);
+uint8 getPassword(uint8 * pass);
+boolean streamPassword(void);
 void checkPassword(uint8* isPassTrue);
+uint16 getDigits(uint8 digits);
+uint8 getUserId(void);
+void adminMenu(void);
+void setTime(void);
+void editSchedule(void);
+void editConfig(void);
 void alarmMode(void);
-void timerCallBack(void);
+void checkLink(void);
+void negotiateBaudRate(void);
+boolean answerBaudRate(void);
+uint8 receiveByte(void);
 
 
 /*******************************************************************************
@@ -60,14 +147,23 @@ void timerCallBack(void);
 int main(void){
 	uint8 key;
 	uint8 isPassTrue;
+	uint8 action, reply;
 	/* Create configuration structure for UART driver */
-	UART_ConfigType uartConfig = {DATA_8_BIT,DISABLED,ONE_BIT,9600};
+	UART_ConfigType uartConfig = {DATA_8_BIT,DISABLED,ONE_BIT,UART_BASE_BAUD_RATE};
+	/* Create configuration structure for the wake up tick :
+	 * use timer 0 (TIMER_MAP_TICK)
+	 * prescaler 64
+	 * compare mode
+	 * initial value = 0
+	 * compare value = 124, so the interrupt occurs every 1 ms
+	 */
+	Timer_ConfigType wakeConfig = {0,124,TIMER_MAP_TICK,F_CPU_64,COMPARE_MODE};
 
 	/* Enable Global Interrupt */
 	SREG_REG.bits.I_bit = LOGIC_HIGH;
 
 	/* Initialize the UART driver with :
-	 * Baud-rate = 9600 bits/sec
+	 * Baud-rate = 9600 bits/sec (base rate until the speed negotiation)
 	 * one stop bit
 	 * No parity
 	 * 8-bit data
@@ -76,22 +172,35 @@ int main(void){
 	/* Initialize the LCD */
 	LCD_init();
 	/* At the beginning, display "Door Lock System"  */
-	LCD_displayString((uint8*)"Door Lock System");
+	LCD_displayString_P(PSTR("Door Lock System"));
 	_delay_ms(500);
 
-	/* when the system start for the first time, create New Password */
-	createPassword();
+	/* Move both ECUs to the fastest baud rate they support */
+	negotiateBaudRate();
+	/* Load the link key and nonce counters from the internal EEPROM */
+	SecureLink_init();
+	/* Start the tick that wakes the MCU from idle while it waits for Control_ECU, it has no call back */
+	if(Timer_claim(TIMER_MAP_TICK,TIMER_USER_TICK)){
+		Timer_init(&wakeConfig,TIMER_USER_TICK);
+	}
+
+	/* create the admin password only if Control_ECU has no password saved yet, until it is saved */
+	do{
+		UART_sendByte(SYSTEM_SETUP);
+	}while((receiveByte() == SETUP_REQUIRED) && !createPassword());
 
 	LCD_clearScreen();
 
 	for(;;){
 		/* Display always the main system options */
-		LCD_displayString((uint8*)"+ : Open Door");
-		LCD_displayStringRowColumn(1,0,(uint8*)"- : Change Pass");
+		LCD_displayString_P(PSTR("+:Open  -:Change"));
+		LCD_displayStringRowColumn_P(1,0,PSTR("*:Admin menu"));
 
 		/* Get the key pressed by user */
 		key = KEYPAD_getPressedKey();
 		_delay_ms(250);
+		/* Control_ECU may have been reset while this ECU waited for the key */
+		checkLink();
 		/* if user chooses (+) Open Door */
 		if(key == '+'){
 			/* The user should enter the password saved in EEPROM */
@@ -99,50 +208,36 @@ int main(void){
 			/* if the user entered the true password */
 			if (isPassTrue == TRUE_PASSWORD) {
 				/* Send UNLOCK_DOOR to the Control ECU to open the Door (rotate motor) */
-				UART_sendByte(UNLOCK_DOOR);
-				/* Set the Call back function pointer in the timer driver */
-				Timer_setCallBack(timerCallBack, TIMER1_ID);
-				/* Initialize the Timer driver :
-				 * use timer 1
-				 * prescaler 1024
-				 * compare mode
-				 * initial value = 0
-				 * compare value = 39062, so the interrupt occurs every 5 seconds
-				 */
-				Timer_init(&timerConfig);
-
-				/* Display Door Unlocking please wait on LCD for 15 seconds */
-				LCD_clearScreen();
-				LCD_displayString((uint8*) "Door Unlocking");
-				LCD_displayStringRowColumn(1, 0, (uint8*) "please wait");
-				 /* wait until t_15s_flag become true, this will happen after 15 seconds */
-				while (t_15s_flag != TRUE);
-				/* reset the flag */
-				t_15s_flag = FALSE;
-
-				/* Display wait for people to enter */
-				LCD_clearScreen();
-				LCD_displayString((uint8*) "wait for people");
-				LCD_displayStringRowColumn(1, 0, (uint8*) "to enter");
-				/* wait until Contro ECU sends LOCKING_DOOR */
-				while (UART_recieveByte() != LOCKING_DOOR);
+				action = UNLOCK_DOOR;
+				SecureLink_send(&action,1);
 
-				/* Set the call back function and initialize timer driver again  */
-				Timer_setCallBack(timerCallBack, TIMER1_ID);
-				Timer_init(&timerConfig);
-
-				/* Display Door Locking on LCD for 15 seconds */
+				/* Display Door Unlocking please wait on LCD, the door time is set in the Control_ECU configuration */
 				LCD_clearScreen();
-				LCD_displayString((uint8*) "Door Locking");
-				/* wait until t_15s_flag become true, this will happen after 15 seconds */
-				while (t_15s_flag != TRUE);
-				/* reset the flag */
-				t_15s_flag = FALSE;
+				LCD_displayString_P(PSTR("Door Unlocking"));
+				LCD_displayStringRowColumn_P(1,0,PSTR("please wait"));
+				/* wait until Control_ECU sends DOOR_UNLOCKED, or ACCESS_DENIED if it rejected the action frame */
+				do{
+					reply = receiveByte();
+				}while ((reply != DOOR_UNLOCKED) && (reply != ACCESS_DENIED));
+
+				if (reply == DOOR_UNLOCKED) {
+					/* Display wait for people to enter */
+					LCD_clearScreen();
+					LCD_displayString_P(PSTR("wait for people"));
+					LCD_displayStringRowColumn_P(1,0,PSTR("to enter"));
+					/* wait until Contro ECU sends LOCKING_DOOR */
+					while (receiveByte() != LOCKING_DOOR);
+
+					/* Display Door Locking on LCD until Control_ECU sends DOOR_LOCKED */
+					LCD_clearScreen();
+					LCD_displayString_P(PSTR("Door Locking"));
+					while (receiveByte() != DOOR_LOCKED);
+				}
 				LCD_clearScreen();
 			}
-			/* if the user entered wrong password 3 times */
-			else if(isPassTrue == WRONG_PASSWORD){
-				/* enter alarm mode for 1 minute */
+			/* if Control_ECU locked the system after too many wrong passwords */
+			else if(isPassTrue == ALARM_MODE){
+				/* show the lockout until Control_ECU ends it */
 				alarmMode();
 			}
 
@@ -155,14 +250,32 @@ int main(void){
 			/* if the user entered the true password */
 			if(isPassTrue == TRUE_PASSWORD){
 				/* Send CHANGE_PASSWORD to the Control ECU to get ready to save new password */
-				UART_sendByte(CHANGE_PASSWORD);
+				action = CHANGE_PASSWORD;
+				SecureLink_send(&action,1);
 				/* Create new password */
 				createPassword();
 				LCD_clearScreen();
 			}
-			/* if the user entered wrong password 3 times */
-			else if(isPassTrue == WRONG_PASSWORD){
-				/* enter alarm mode for 1 minute */
+			/* if Control_ECU locked the system after too many wrong passwords */
+			else if(isPassTrue == ALARM_MODE){
+				/* show the lockout until Control_ECU ends it */
+				alarmMode();
+			}
+		}
+		/* if user chooses (*) Admin menu, only the admin is allowed by Control_ECU */
+		else if(key == '*'){
+			/* The user should enter the password saved in EEPROM */
+			checkPassword(&isPassTrue);
+
+			/* if the user entered the true password */
+			if(isPassTrue == TRUE_PASSWORD){
+				/* Add or remove a user or set the clock */
+				adminMenu();
+				LCD_clearScreen();
+			}
+			/* if Control_ECU locked the system after too many wrong passwords */
+			else if(isPassTrue == ALARM_MODE){
+				/* show the lockout until Control_ECU ends it */
 				alarmMode();
 			}
 		}
@@ -173,66 +286,85 @@ int main(void){
 /*
  * Description :
  * Function responsible for :
- * 1. Display error message on LCD for 1 minute
- * 2. Wait for 1 minute and no inputs from the keypad will be accepted during this time period.
+ * 1. Display error message on LCD with the seconds left in the lockout.
+ * 2. Ask Control_ECU for the seconds left until it ends the lockout, no inputs from the keypad are accepted meanwhile.
  */
 void alarmMode(void){
-	/* Set alarm flag */
-	alarm_flag = TRUE;
-
-	/* Set the call back function and initialize timer driver again  */
-	Timer_setCallBack(timerCallBack, TIMER1_ID);
-	Timer_init(&timerConfig);
+	uint16 remaining;
 
 	/* Display error message on LCD */
 	LCD_clearScreen();
-	LCD_displayString((uint8*)"System LOCKED");
-	LCD_displayStringRowColumn(1,0,(uint8*)"Wait for 1 min");
-
-	/* wait until t_60s_flag become true, this will happen after 1 minute */
-	while(t_60s_flag != TRUE);
-	/* reset the flag */
-	t_60s_flag = FALSE;
-	/* Reset alarm flag */
-	alarm_flag = FALSE;
+	LCD_displayString_P(PSTR("System LOCKED"));
+
+	for(;;){
+		/* the lockout time is kept by Control_ECU, so a reset of this ECU can't shorten it */
+		UART_sendByte(LOCKOUT_STATUS);
+		remaining = (uint16)receiveByte() << 8;
+		remaining |= receiveByte();
+		if(remaining == 0){
+			break;
+		}
+
+		LCD_displayStringRowColumn_P(1,0,PSTR("Wait "));
+		LCD_intgerToString(remaining);
+		LCD_displayString_P(PSTR(" s   "));
+		_delay_ms(500);
+	}
 	LCD_clearScreen();
 }
 
 /*
  * Description :
  * Function responsible for :
- * 1. get the password from the user.
- * 2. send it to Control ECU.
- * 3. set a flag to  TRUE_PASSWORD if the user enters the true password
- *    or to WRONG_PASSWORD if the user enters a wrong password.
+ * 1. get the user id from the user and send it to Control ECU, which reads the user record meanwhile.
+ * 2. get the password from the user, each key is sent to Control_ECU in a key frame when it is pressed.
+ *    If Control_ECU dropped the login meanwhile the link is checked.
+ * 3. repeat until Control_ECU answers TRUE_PASSWORD, ALARM_MODE when the wrong passwords locked the system
+ *    or OUT_OF_SCHEDULE when the user isn't allowed at this time.
+ *    The attempts are counted by Control_ECU, so a reset of this ECU gives no new attempts.
  */
 void checkPassword(uint8* flag_ptr){
-	uint8 size = PASSWORD_SIZE+2;
-	uint8 pass[size] , loop_counter;
+	uint8 id;
 
-	/* loop 3 times each time get password from the user it true return */
-	for(loop_counter = 0 ; loop_counter<3 ; loop_counter++){
+	do{
 		LCD_clearScreen();
-		LCD_displayString((uint8*)"enter old pass:");
+		LCD_displayString_P(PSTR("enter user id:"));
 		LCD_moveCursor(1,0);
 
-		/* Get the password from the user */
-		getPassword(pass,size);
-		/* wait until the user press enter button */
-		while(KEYPAD_getPressedKey() != '=');
-		_delay_ms(250);
-
-		/* Wait until Control_ECU is ready to receive the password */
-		while(UART_recieveByte() != CONTROL_ECU_READY);
-		/* send the password */
-		UART_sendString(pass);
-
-		/* if the password is true Control_ECU will send TRUE_PASSWORD , if not it will sends WRONG_PASSWORD */
-		*flag_ptr = UART_recieveByte();
-		if(*flag_ptr == TRUE_PASSWORD){
-			return;
+		/* Get the user id from the user */
+		id = getUserId();
+
+		/* Ask Control_ECU to start a login, it answers ALARM_MODE if the system is locked */
+		UART_sendByte(LOGIN_REQUEST);
+		*flag_ptr = receiveByte();
+		if(*flag_ptr == CONTROL_ECU_READY){
+			/* send the user id encrypted through the secure link */
+			SecureLink_send(&id,1);
+
+			LCD_clearScreen();
+			LCD_displayString_P(PSTR("enter old pass:"));
+			LCD_moveCursor(1,0);
+
+			/* Get the password from the user until the enter button, Control_ECU hashes it meanwhile */
+			if(streamPassword()){
+				/* Control_ECU answers TRUE_PASSWORD, WRONG_PASSWORD or ALARM_MODE if this failure locked the system */
+				*flag_ptr = receiveByte();
+			}else{
+				/* Control_ECU lost a key frame, the login is dropped without counting an attempt */
+				LCD_clearScreen();
+				LCD_displayString_P(PSTR("Link error"));
+				_delay_ms(1000);
+				checkLink();
+			}
 		}
-	} /* it will reach here if the user enters wrong password 3 times and then (*flag_ptr=WRONG_PASSWORD)  */
+	}while((*flag_ptr != TRUE_PASSWORD) && (*flag_ptr != ALARM_MODE) && (*flag_ptr != OUT_OF_SCHEDULE));
+
+	if(*flag_ptr == OUT_OF_SCHEDULE){
+		LCD_clearScreen();
+		LCD_displayString_P(PSTR("Not allowed now"));
+		_delay_ms(1000);
+		LCD_clearScreen();
+	}
 }
 
 /*
@@ -240,45 +372,47 @@ void checkPassword(uint8* flag_ptr){
  * Function responsible for create new password by:
  * 1. take the password from the user and take the password again for confirmation.
  * 2. send the two passwords to Control_ECU.
- * 3. it will repeat until the user enters the same password twice
+ * 3. it will repeat until the user enters the same password twice, or Control_ECU gives up with PASSWORD_NOT_SAVED.
+ * Return TRUE if the password is saved.
  */
-void createPassword(void){
-	uint8 size = PASSWORD_SIZE+2;
-	uint8 pass1[size], pass2[size];
+boolean createPassword(void){
+	uint8 pass1[PASSWORD_MAX_SIZE], pass2[PASSWORD_MAX_SIZE];
+	uint8 length1, length2;
 	uint8 isSaved;
 	/* loop until the user enters same password twice for confirmation */
 	for(;;){
 		LCD_clearScreen();
-		LCD_displayStringRowColumn(0,0,(uint8*)"plz enter pass: ");
+		LCD_displayStringRowColumn_P(0,0,PSTR("plz enter pass: "));
 		LCD_moveCursor(1,0);
 
-		/* Get the password from the user */
-		getPassword(pass1,size);
-		/* wait until the user press enter button */
-		while(KEYPAD_getPressedKey() != '=');
-		_delay_ms(250);
+		/* Get the password from the user until the enter button */
+		length1 = getPassword(pass1);
 
 		LCD_clearScreen();
-		LCD_displayStringRowColumn(0,0,(uint8*)"plz re-enter the");
-		LCD_displayStringRowColumn(1,0,(uint8*)"same pass:");
+		LCD_displayStringRowColumn_P(0,0,PSTR("plz re-enter the"));
+		LCD_displayStringRowColumn_P(1,0,PSTR("same pass:"));
 
 		/* Get the password again from the user for confirmation */
-		getPassword(pass2,size);
-		/* wait until the user press enter button */
-		while(KEYPAD_getPressedKey() != '=');
-		_delay_ms(250);
+		length2 = getPassword(pass2);
 
 		/* Wait until Control_ECU is ready to receive the password */
-		while(UART_recieveByte() != CONTROL_ECU_READY);
-		/* send the to passwords to Control_ECU */
-		UART_sendString(pass1);
-		UART_sendString(pass2);
+		while(receiveByte() != CONTROL_ECU_READY);
+		/* send the two passwords encrypted to Control_ECU */
+		SecureLink_send(pass1,length1);
+		SecureLink_send(pass2,length2);
 
 		/* if the two passwords are the same Control_ECU will save the password in the EEPROM and send PASSWORD_SAVED */
-		isSaved = UART_recieveByte();
+		isSaved = receiveByte();
 		/* if Control_ECU saves the password return */
 		if(isSaved == PASSWORD_SAVED){
-			return;
+			return TRUE;
+		}
+		/* the EEPROM write failed or the passwords were not the same too many times */
+		if(isSaved == PASSWORD_NOT_SAVED){
+			LCD_clearScreen();
+			LCD_displayString_P(PSTR("Pass not saved"));
+			_delay_ms(1000);
+			return FALSE;
 		}
 	}
 
@@ -287,37 +421,408 @@ void createPassword(void){
 /*
  * Description :
  * Function responsible for take password from user.
+ * Digits are accepted until the enter button, which is ignored before PASSWORD_MIN_SIZE digits,
+ * and digits after PASSWORD_MAX_SIZE are ignored. Return the number of digits.
+ */
+uint8 getPassword(uint8 * pass){
+	uint8 length = 0;
+	uint8 key;
+
+	for(;;){
+		key = KEYPAD_getPressedKey();
+		_delay_ms(250);
+		if((key == '=') && (length >= PASSWORD_MIN_SIZE)){
+			return length;
+		}
+		if((key <= 9) && (length < PASSWORD_MAX_SIZE)){
+			pass[length++] = key + '0';
+			LCD_displayCharacter('*');
+		}
+	}
+}
+
+/*
+ * Description :
+ * Function responsible for getting the password from the user like getPassword,
+ * but every key pressed is sent to Control_ECU as soon as it is pressed, in a key frame of one encrypted byte:
+ * the digits, the enter button and the ignored keys give the same frames, so they don't show the password or its length.
+ * Return FALSE to abort the login if Control_ECU dropped it, it sends LOGIN_ABORTED then.
  */
-void getPassword(uint8 * pass, uint8 size){
-	uint8 loop_counter;
-	for (loop_counter = 0; loop_counter < size-2; loop_counter++) {
-		pass[loop_counter] = KEYPAD_getPressedKey() + 48;
-		LCD_displayCharacter('*');
+boolean streamPassword(void){
+	uint8 length = 0;
+	uint8 key;
+
+	for(;;){
+		key = KEYPAD_getPressedKey();
 		_delay_ms(250);
+		/* Control_ECU sends nothing before the end of the password unless it dropped the login */
+		if(UART_isByteReceived()){
+			return FALSE;
+		}
+		if(key <= 9){
+			key += '0';
+		}
+		SecureLink_send(&key,1);
+
+		if((key == '=') && (length >= PASSWORD_MIN_SIZE)){
+			return TRUE;
+		}
+		if((key >= '0') && (key <= '9') && (length < PASSWORD_MAX_SIZE)){
+			length++;
+			LCD_displayCharacter('*');
+		}
 	}
-	/* end the password with # and null */
-	pass[loop_counter++] = '#';
-	pass[loop_counter] = '\0';
 }
 
 /*
  * Description :
- * call-back function.
+ * Function responsible for checking that Control_ECU answers before a new exchange starts.
+ * If it doesn't, or it proposed a baud rate meanwhile, one of the ECUs was reset since the last exchange:
+ * the baud rate is negotiated again and the next frames take a new block of counters.
  */
-void timerCallBack(void){
-	tick++;
-	if((!alarm_flag) && (tick == 3)){
-		t_15s_flag = TRUE;
-		tick = 0;
-		Timer_deInit(TIMER1_ID);
-	}else if((alarm_flag) && (tick == 12)){
-		t_60s_flag = TRUE;
-		tick = 0;
-		Timer_deInit(TIMER1_ID);
+void checkLink(void){
+	uint8 reply;
+	boolean restarted = FALSE;
+
+	/* drop the bytes left from an interrupted exchange or received with another baud rate */
+	while(UART_isByteReceived()){
+		if(UART_recieveByte() == BAUD_REQUEST){
+			restarted = TRUE;
+		}
+	}
+	if(!restarted){
+		UART_sendByte(HEARTBEAT);
+		restarted = !UART_receiveByteTimeout(&reply,LINK_CHECK_TIMEOUT_MS) || (reply != HEARTBEAT_ACK);
+	}
+	if(restarted){
+		negotiateBaudRate();
+		SecureLink_skipReservation();
 	}
 }
 
+/*
+ * Description :
+ * Function responsible for starting a speed negotiation with Control_ECU, whatever its current baud rate:
+ * 1. Send BAUD_REQUEST with one of the candidate rates, the base rate first.
+ * 2. Control_ECU goes back to the base rate when it receives it and proposes its rates.
+ * 3. Answer the proposals at the base rate, or try the next candidate rate if none arrives.
+ */
+void negotiateBaudRate(void){
+	static const UART_BaudRateType rates[UART_NUM_OF_NEGOTIATION_RATES] PROGMEM = UART_NEGOTIATION_BAUD_RATES;
+	uint8 index = UART_NUM_OF_NEGOTIATION_RATES - 1;
 
+	for(;;){
+		/* Control_ECU only understands BAUD_REQUEST sent with its current rate */
+		if(UART_setBaudRate(pgm_read_dword(&rates[index]))){
+			UART_sendByte(BAUD_REQUEST);
+			UART_setBaudRate(UART_BASE_BAUD_RATE);
+			if(answerBaudRate()){
+				return;
+			}
+		}
+		index = (index == 0) ? (UART_NUM_OF_NEGOTIATION_RATES - 1) : (index - 1);
+	}
+}
 
+/*
+ * Description :
+ * Function responsible for answering the Control_ECU speed negotiation:
+ * 1. Receive BAUD_REQUEST with the index of the proposed baud rate.
+ * 2. Accept it only if this ECU can generate it within 2% error.
+ * 3. Switch to the accepted rate after the answer is completely sent.
+ * Return FALSE if no rate was accepted within BAUD_LISTEN_TIMEOUT_MS of the last proposal.
+ */
+boolean answerBaudRate(void){
+	static const UART_BaudRateType rates[UART_NUM_OF_NEGOTIATION_RATES] PROGMEM = UART_NEGOTIATION_BAUD_RATES;
+	uint8 data, index;
+	uint16 ubrr_value;
+	boolean u2x;
+
+	/* Wait until Control_ECU proposes a baud rate, other bytes are skipped */
+	while(UART_receiveByteTimeout(&data,BAUD_LISTEN_TIMEOUT_MS)){
+		if((data != BAUD_REQUEST) || !UART_receiveByteTimeout(&index,BAUD_LISTEN_TIMEOUT_MS)){
+			continue;
+		}
 
+		if((index < UART_NUM_OF_NEGOTIATION_RATES) && UART_calculateBaudRate(pgm_read_dword(&rates[index]),&ubrr_value,&u2x)){
+			UART_sendByte(BAUD_ACCEPTED);
+			/* UART_setBaudRate waits until BAUD_ACCEPTED is sent with the old rate */
+			UART_setBaudRate(pgm_read_dword(&rates[index]));
+			return TRUE;
+		}else{
+			UART_sendByte(BAUD_REJECTED);
+		}
+	}
+	return FALSE;
+}
 
+/*
+ * Description :
+ * Function responsible for take a decimal number of the given digits from the user, other keys are ignored.
+ */
+uint16 getDigits(uint8 digits){
+	uint16 value = 0;
+	uint8 key, loop_counter;
+
+	for(loop_counter = 0 ; loop_counter < digits ; loop_counter++){
+		/* accept digits only */
+		do{
+			key = KEYPAD_getPressedKey();
+		}while(key > 9);
+		value = (value * 10) + key;
+		LCD_displayCharacter(key + '0');
+		_delay_ms(250);
+	}
+	return value;
+}
+
+/*
+ * Description :
+ * Function responsible for take the user id digits from the user until the enter button.
+ */
+uint8 getUserId(void){
+	uint8 id = (uint8)getDigits(USER_ID_DIGITS);
+
+	/* wait until the user press enter button */
+	while(KEYPAD_getPressedKey() != '=');
+	_delay_ms(250);
+	return id;
+}
+
+/*
+ * Description :
+ * Function responsible for the admin options:
+ * 1. choose to add or remove a user, set the clock, edit the schedules or the configuration
+ *    and send the action to Control_ECU.
+ * 2. Control_ECU refuses if the logged in user is not the admin.
+ * 3. send the user id, then create its password (add) or show it is removed (remove).
+ */
+void adminMenu(void){
+	uint8 key, action, id;
+
+	LCD_clearScreen();
+	LCD_displayString_P(PSTR("1:Add 2:Del 3:Tm"));
+	LCD_displayStringRowColumn_P(1,0,PSTR("4:Sched 5:Config"));
+	do{
+		key = KEYPAD_getPressedKey();
+	}while((key < 1) || (key > 5));
+	_delay_ms(250);
+
+	/* Send the action to the Control ECU, it answers if the logged in user is the admin */
+	switch(key){
+	case 1:
+		action = ENROLL_USER;
+		break;
+	case 2:
+		action = REVOKE_USER;
+		break;
+	case 3:
+		action = SET_TIME;
+		break;
+	case 4:
+		action = SCHEDULE_EDIT;
+		break;
+	default:
+		action = CONFIG_EDIT;
+		break;
+	}
+	SecureLink_send(&action,1);
+	if(receiveByte() != ACCESS_GRANTED){
+		LCD_clearScreen();
+		LCD_displayString_P(PSTR("Admin only"));
+		_delay_ms(1000);
+		return;
+	}
+
+	if(action == SET_TIME){
+		setTime();
+		return;
+	}
+	if(action == SCHEDULE_EDIT){
+		editSchedule();
+		return;
+	}
+	if(action == CONFIG_EDIT){
+		editConfig();
+		return;
+	}
+
+	LCD_clearScreen();
+	LCD_displayString_P(PSTR("enter user id:"));
+	LCD_moveCursor(1,0);
+	id = getUserId();
+	SecureLink_send(&id,1);
+	if(receiveByte() != USER_SLOT_OK){
+		LCD_clearScreen();
+		LCD_displayString_P(PSTR("Invalid user id"));
+		_delay_ms(1000);
+		return;
+	}
+
+	if(action == ENROLL_USER){
+		/* Create the password of the new user */
+		createPassword();
+	}else{
+		LCD_clearScreen();
+		LCD_displayString_P(PSTR("User removed"));
+		_delay_ms(1000);
+	}
+}
+
+/*
+ * Description :
+ * Function responsible for setting the Control_ECU clock:
+ * 1. take the date and time as YYMMDDhhmm from the user.
+ * 2. send them through the secure link, Control_ECU checks the date and answers.
+ */
+void setTime(void){
+	uint8 frame[TIME_FRAME_SIZE];
+	uint8 field;
+
+	LCD_clearScreen();
+	LCD_displayString_P(PSTR("YYMMDDhhmm:"));
+	LCD_moveCursor(1,0);
+	for(field = 0 ; field < TIME_FIELDS ; field++){
+		frame[field] = getDigits(TIME_FIELD_DIGITS);
+	}
+	/* the seconds start from zero */
+	frame[TIME_FIELDS] = 0;
+	/* wait until the user press enter button */
+	while(KEYPAD_getPressedKey() != '=');
+	_delay_ms(250);
+
+	SecureLink_send(frame,TIME_FRAME_SIZE);
+	LCD_clearScreen();
+	if(receiveByte() == TIME_ACCEPTED){
+		LCD_displayString_P(PSTR("Time set"));
+	}else{
+		LCD_displayString_P(PSTR("Invalid time"));
+	}
+	_delay_ms(1000);
+}
+
+/*
+ * Description :
+ * Function responsible for editing the schedules of Control_ECU:
+ * 1. add a rule "profile allowed from day to day, from hh:mm to hh:mm" (days 1 = Monday to 7 = Sunday),
+ *    clear a profile, or assign a profile to a user (profile 9 removes the restrictions).
+ * 2. send the schedule frame through the secure link and show the answer of Control_ECU.
+ */
+void editSchedule(void){
+	uint8 frame[SCHEDULE_FRAME_SIZE] = {0};
+	uint8 key, profile;
+
+	LCD_clearScreen();
+	LCD_displayString_P(PSTR("1:Rule  2:Clear"));
+	LCD_displayStringRowColumn_P(1,0,PSTR("3:Assign user"));
+	do{
+		key = KEYPAD_getPressedKey();
+	}while((key < 1) || (key > 3));
+	_delay_ms(250);
+
+	if(key == 3){
+		frame[0] = SCHEDULE_OP_ASSIGN;
+		LCD_clearScreen();
+		LCD_displayString_P(PSTR("enter user id:"));
+		LCD_moveCursor(1,0);
+		frame[1] = getDigits(USER_ID_DIGITS);
+		LCD_clearScreen();
+		LCD_displayString_P(PSTR("profile 0-4,9:"));
+		LCD_moveCursor(1,0);
+		profile = getDigits(1);
+		frame[2] = (profile == NO_PROFILE_DIGIT) ? SCHEDULE_NO_PROFILE : profile;
+	}else{
+		frame[0] = (key == 1) ? SCHEDULE_OP_RULE : SCHEDULE_OP_CLEAR;
+		LCD_clearScreen();
+		LCD_displayString_P(PSTR("profile 0-4:"));
+		LCD_moveCursor(1,0);
+		frame[1] = getDigits(1);
+
+		if(key == 1){
+			LCD_clearScreen();
+			LCD_displayString_P(PSTR("days 1-7 from-to"));
+			LCD_moveCursor(1,0);
+			/* the days are sent from 0 (Monday), a day 0 becomes 255 and is refused by Control_ECU */
+			frame[2] = getDigits(1) - 1;
+			LCD_displayCharacter('-');
+			frame[3] = getDigits(1) - 1;
+
+			LCD_clearScreen();
+			LCD_displayString_P(PSTR("from hhmm:"));
+			LCD_moveCursor(1,0);
+			frame[4] = getDigits(2);
+			frame[5] = getDigits(2);
+
+			LCD_clearScreen();
+			LCD_displayString_P(PSTR("to hhmm:"));
+			LCD_moveCursor(1,0);
+			frame[6] = getDigits(2);
+			frame[7] = getDigits(2);
+		}
+	}
+	/* wait until the user press enter button */
+	while(KEYPAD_getPressedKey() != '=');
+	_delay_ms(250);
+
+	SecureLink_send(frame,SCHEDULE_FRAME_SIZE);
+	LCD_clearScreen();
+	if(receiveByte() == SCHEDULE_OK){
+		LCD_displayString_P(PSTR("Schedule saved"));
+	}else{
+		LCD_displayString_P(PSTR("Invalid schedule"));
+	}
+	_delay_ms(1000);
+}
+
+/*
+ * Description :
+ * Function responsible for changing one field of the Control_ECU configuration:
+ * 1. take the field number and its new value from the user.
+ *    1:door seconds 2:motor speed 3:user attempts 4:system attempts
+ *    5:lockout seconds 6:lockout doublings 7:fastest baud rate index
+ * 2. send them through the secure link, Control_ECU checks the range and answers.
+ */
+void editConfig(void){
+	uint8 frame[CONFIG_FRAME_SIZE];
+	uint16 value;
+
+	LCD_clearScreen();
+	LCD_displayString_P(PSTR("field 1-7:"));
+	LCD_moveCursor(1,0);
+	frame[0] = (uint8)getDigits(CONFIG_FIELD_DIGITS);
+
+	LCD_clearScreen();
+	LCD_displayString_P(PSTR("value 000-999:"));
+	LCD_moveCursor(1,0);
+	value = getDigits(CONFIG_VALUE_DIGITS);
+	frame[1] = (uint8)(value >> 8);
+	frame[2] = (uint8)value;
+	/* wait until the user press enter button */
+	while(KEYPAD_getPressedKey() != '=');
+	_delay_ms(250);
+
+	SecureLink_send(frame,CONFIG_FRAME_SIZE);
+	LCD_clearScreen();
+	if(receiveByte() == CONFIG_OK){
+		LCD_displayString_P(PSTR("Config saved"));
+	}else{
+		LCD_displayString_P(PSTR("Invalid value"));
+	}
+	_delay_ms(1000);
+}
+
+/*
+ * Description :
+ * Function responsible for receive byte from Control_ECU, sleeping in idle mode until it arrives.
+ * The RX interrupt wakes the MCU and queues up to UART_RX_QUEUE_SIZE bytes, so a reply may be longer than the UART buffer.
+ */
+uint8 receiveByte(void){
+	/* check with the interrupts disabled, so a byte received just before the sleep instruction still wakes the MCU */
+	SREG_REG.bits.I_bit = LOGIC_LOW;
+	while(!UART_isByteReceived()){
+		Power_sleep(POWER_IDLE);
+		SREG_REG.bits.I_bit = LOGIC_LOW;
+	}
+	SREG_REG.bits.I_bit = LOGIC_HIGH;
+	return UART_recieveByte();
+}
@@ -12,6 +12,52 @@
 #include "keypad.h"
 #include "gpio.h"
 #include <util/delay.h>
+#include <avr/pgmspace.h>
+#ifdef KEYPAD_WAKE_UP_ENABLED
+#include "power.h"
+#include "ATmega32_Registers.h"
+#include <avr/interrupt.h>
+#endif
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Delay after each row, so one scan of the keypad takes KEYPAD_NUM_ROWS times this delay */
+#define KEYPAD_ROW_DELAY_MS               10
+
+#ifdef KEYPAD_WAKE_UP_ENABLED
+#define KEYPAD_IDLE_TIMEOUT_SCANS         (KEYPAD_IDLE_TIMEOUT_MS / (KEYPAD_NUM_ROWS * KEYPAD_ROW_DELAY_MS))
+
+#if (KEYPAD_WAKE_UP_INT == 0)
+#define KEYPAD_WAKE_UP_PIN_ID             PIN2_ID
+#define KEYPAD_WAKE_UP_VECTOR             INT0_vect
+#else
+#define KEYPAD_WAKE_UP_PIN_ID             PIN3_ID
+#define KEYPAD_WAKE_UP_VECTOR             INT1_vect
+#endif
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Value of each button, in the order of the button numbers (row * KEYPAD_NUM_COLS + col + 1), kept in flash */
+#if (KEYPAD_NUM_COLS == 3)
+static const uint8 g_keypad4x3Map[KEYPAD_NUM_ROWS * KEYPAD_NUM_COLS] PROGMEM = {
+	1, 2, 3,
+	4, 5, 6,
+	7, 8, 9,
+	'*', 0, '#'
+};
+#elif (KEYPAD_NUM_COLS == 4)
+static const uint8 g_keypad4x4Map[KEYPAD_NUM_ROWS * KEYPAD_NUM_COLS] PROGMEM = {
+	7, 8, 9, '%',
+	4, 5, 6, '*',
+	1, 2, 3, '-',
+	13, 0, '=', '+'		/* 13 is the ASCII of Enter */
+};
+#endif
 
 /*******************************************************************************
  *                      Functions Prototypes(Private)                          *
@@ -31,13 +77,35 @@ static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number);
 static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number);
 #endif
 
+#ifdef KEYPAD_WAKE_UP_ENABLED
+/*
+ * Function responsible for sleeping in power down mode until any key is pressed
+ */
+static void KEYPAD_sleepUntilPressed(void);
+static void KEYPAD_enableWakeUp(uint8 enable);
+#endif
+
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
 
+#ifdef KEYPAD_WAKE_UP_ENABLED
+/*
+ * The wake up interrupt is level triggered, disable it at the first call so it doesn't repeat
+ * while the key is held, the scan in KEYPAD_getPressedKey identifies the key.
+ */
+ISR(KEYPAD_WAKE_UP_VECTOR)
+{
+	KEYPAD_enableWakeUp(FALSE);
+}
+#endif
+
 uint8 KEYPAD_getPressedKey(void)
 {
 	uint8 col,row;
+#ifdef KEYPAD_WAKE_UP_ENABLED
+	uint16 idle_scans = 0;
+#endif
 	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID, PIN_INPUT);
 	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+1, PIN_INPUT);
 	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+2, PIN_INPUT);
@@ -75,11 +143,87 @@ uint8 KEYPAD_getPressedKey(void)
 				}
 			}
 			GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_INPUT);
-			_delay_ms(10); /* Add small delay to fix CPU load issue in proteus */
+			_delay_ms(KEYPAD_ROW_DELAY_MS); /* Add small delay to fix CPU load issue in proteus */
+		}
+#ifdef KEYPAD_WAKE_UP_ENABLED
+		/* nobody used the keypad for KEYPAD_IDLE_TIMEOUT_MS, sleep until the next press */
+		idle_scans++;
+		if(idle_scans >= KEYPAD_IDLE_TIMEOUT_SCANS)
+		{
+			KEYPAD_sleepUntilPressed();
+			idle_scans = 0;
 		}
+#endif
 	}	
 }
 
+#ifdef KEYPAD_WAKE_UP_ENABLED
+/*
+ * Description :
+ * Drive all the rows to the pressed level, so a press on any key pulls its column and the
+ * interrupt pin through the diode-OR, then sleep in power down mode until it happens.
+ */
+static void KEYPAD_sleepUntilPressed(void)
+{
+	uint8 row, col;
+	boolean pressed = FALSE;
+
+	/* the interrupt pin is pulled up internally, the diodes can only pull it down */
+	GPIO_setupPinDirection(PORTD_ID, KEYPAD_WAKE_UP_PIN_ID, PIN_INPUT);
+	GPIO_writePin(PORTD_ID, KEYPAD_WAKE_UP_PIN_ID, LOGIC_HIGH);
+
+	for(row=0 ; row<KEYPAD_NUM_ROWS ; row++)
+	{
+		GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_OUTPUT);
+		GPIO_writePin(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+row, KEYPAD_BUTTON_PRESSED);
+	}
+
+	/* a key pressed meanwhile must not be missed, check it with the interrupts disabled */
+	SREG_REG.bits.I_bit = LOGIC_LOW;
+	for(col=0 ; col<KEYPAD_NUM_COLS ; col++)
+	{
+		if(GPIO_readPin(KEYPAD_COL_PORT_ID,KEYPAD_FIRST_COL_PIN_ID+col) == KEYPAD_BUTTON_PRESSED)
+		{
+			pressed = TRUE;
+		}
+	}
+	if(pressed)
+	{
+		SREG_REG.bits.I_bit = LOGIC_HIGH;
+	}
+	else
+	{
+		KEYPAD_enableWakeUp(TRUE);
+		/* interrupts are enabled again by Power_sleep just before the sleep instruction */
+		Power_sleep(POWER_DOWN);
+		KEYPAD_enableWakeUp(FALSE);
+	}
+
+	for(row=0 ; row<KEYPAD_NUM_ROWS ; row++)
+	{
+		GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_INPUT);
+	}
+}
+
+/*
+ * Description :
+ * Enable or disable the low level wake up interrupt of the keypad.
+ * Only the low level trigger can wake the MCU from power down mode.
+ */
+static void KEYPAD_enableWakeUp(uint8 enable)
+{
+#if (KEYPAD_WAKE_UP_INT == 0)
+	MCUCR_REG.Bits.ISC00_bit = LOGIC_LOW;
+	MCUCR_REG.Bits.ISC01_bit = LOGIC_LOW;
+	GICR_REG.Bits.INT0_bit = enable;
+#else
+	MCUCR_REG.Bits.ISC10_bit = LOGIC_LOW;
+	MCUCR_REG.Bits.ISC11_bit = LOGIC_LOW;
+	GICR_REG.Bits.INT1_bit = enable;
+#endif
+}
+#endif
+
 #if (KEYPAD_NUM_COLS == 3)
 /*
  * Description :
@@ -87,20 +231,8 @@ uint8 KEYPAD_getPressedKey(void)
  */
 static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number)
 {
-	uint8 keypad_button = 0;
-	switch(button_number)
-	{
-		case 10: keypad_button = '*'; // ASCII Code of *
-				 break;
-		case 11: keypad_button = 0;
-				 break;
-		case 12: keypad_button = '#'; // ASCII Code of #
-				 break;
-		default: keypad_button = button_number;
-				break;
-	}
-	return keypad_button;
-} 
+	return pgm_read_byte(&g_keypad4x3Map[button_number - 1]);
+}
 
 #elif (KEYPAD_NUM_COLS == 4)
 
@@ -110,45 +242,7 @@ static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number)
  */
 static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number)
 {
-	uint8 keypad_button = 0;
-	switch(button_number)
-	{
-		case 1: keypad_button = 7;
-				break;
-		case 2: keypad_button = 8;
-				break;
-		case 3: keypad_button = 9;
-				break;
-		case 4: keypad_button = '%'; // ASCII Code of %
-				break;
-		case 5: keypad_button = 4;
-				break;
-		case 6: keypad_button = 5;
-				break;
-		case 7: keypad_button = 6;
-				break;
-		case 8: keypad_button = '*'; /* ASCII Code of '*' */
-				break;
-		case 9: keypad_button = 1;
-				break;
-		case 10: keypad_button = 2;
-				break;
-		case 11: keypad_button = 3;
-				break;
-		case 12: keypad_button = '-'; /* ASCII Code of '-' */
-				break;
-		case 13: keypad_button = 13;  /* ASCII of Enter */
-				break;
-		case 14: keypad_button = 0;
-				break;
-		case 15: keypad_button = '='; /* ASCII Code of '=' */
-				break;
-		case 16: keypad_button = '+'; /* ASCII Code of '+' */
-				break;
-		default: keypad_button = button_number;
-				break;
-	}
-	return keypad_button;
-} 
+	return pgm_read_byte(&g_keypad4x4Map[button_number - 1]);
+}
 
 #endif
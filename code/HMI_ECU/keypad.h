@@ -34,6 +34,16 @@
 #define KEYPAD_BUTTON_PRESSED            LOGIC_LOW
 #define KEYPAD_BUTTON_RELEASED           LOGIC_HIGH
 
+/*
+ * Low power wait : the columns are also wired through a diode-OR to an external interrupt pin
+ * (INT0 = PD2 or INT1 = PD3). After KEYPAD_IDLE_TIMEOUT_MS without a key the rows are all driven
+ * to the pressed level and the MCU sleeps in power down mode until a key pulls the interrupt pin.
+ * Keep KEYPAD_WAKE_UP_ENABLED commented if the board doesn't have this wiring.
+ */
+//#define KEYPAD_WAKE_UP_ENABLED
+#define KEYPAD_WAKE_UP_INT                0
+#define KEYPAD_IDLE_TIMEOUT_MS            5000
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
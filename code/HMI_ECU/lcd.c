@@ -12,6 +12,7 @@
 #include <util/delay.h>
 #include <stdlib.h>
 #include "common_macros.h"
+#include <avr/pgmspace.h>
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
@@ -162,6 +163,21 @@ void LCD_displayString(const uint8 *str) {
 	}
 }
 
+/*
+ * Description :
+ * Display the required string saved in flash on the screen, it isn't copied to the RAM
+ */
+void LCD_displayString_P(const char *str) {
+	uint8 character = pgm_read_byte(str);
+
+	while (character) {
+		/* Display each character of the string */
+		LCD_displayCharacter(character);
+		str++;
+		character = pgm_read_byte(str);
+	}
+}
+
 /*
  * Description :
  * Move the cursor to a specified row and column index on the screen
@@ -199,6 +215,17 @@ void LCD_displayStringRowColumn(uint8 row, uint8 col, const uint8 *str) {
 	LCD_displayString(str);
 }
 
+/*
+ * Description :
+ * Display the required string saved in flash in a specified row and column index on the screen
+ */
+void LCD_displayStringRowColumn_P(uint8 row, uint8 col, const char *str) {
+	/* Go to the required position */
+	LCD_moveCursor(row, col);
+	/* display the string */
+	LCD_displayString_P(str);
+}
+
 /*
  * Description :
  * Display the required decimal value on the screen
@@ -216,17 +243,39 @@ void LCD_intgerToString(sint32 data) {
 
 /*
  * Description :
- * Display the required float value on the screen
+ * Display the required fixed point value on the screen, the value is data / 10^decimals.
+ * Only integer operations are used, so the floating point library isn't linked.
  */
-void LCD_floatToString(float32 data) {
-	/* Buffer to hold the resulting string */
+void LCD_fixedToString(sint32 data, uint8 decimals) {
+	/* String to hold the ASCII integer part */
 	uint8 buff[16];
+	uint32 magnitude, divisor = 1;
+	uint8 i;
 
-	/* Convert float to string with 2 decimal precision */
-	dtostrf(data, 0, 2, (char*) buff);
+	for (i = 0; i < decimals; i++) {
+		divisor *= 10;
+	}
 
-	/* Display the string */
+	if (data < 0) {
+		LCD_displayCharacter('-');
+		magnitude = -(uint32)data;
+	} else {
+		magnitude = (uint32)data;
+	}
+
+	/* Display the integer part */
+	ultoa(magnitude / divisor, (char*)buff, 10);
 	LCD_displayString(buff);
+
+	/* Display the fraction digits, with their leading zeros */
+	if (decimals != 0) {
+		LCD_displayCharacter('.');
+		magnitude %= divisor;
+		while (divisor > 1) {
+			divisor /= 10;
+			LCD_displayCharacter('0' + ((magnitude / divisor) % 10));
+		}
+	}
 }
 
 /*
@@ -86,6 +86,12 @@ void LCD_displayCharacter(uint8 character);
  */
 void LCD_displayString(const uint8 *str);
 
+/*
+ * Description :
+ * Display the required string saved in flash on the screen, use it with PSTR("...")
+ */
+void LCD_displayString_P(const char *str);
+
 
 /*
  * Description :
@@ -99,6 +105,12 @@ void LCD_moveCursor(uint8 row,uint8 col);
  */
 void LCD_displayStringRowColumn(uint8 row,uint8 col,const uint8 *Str);
 
+/*
+ * Description :
+ * Display the required string saved in flash in a specified row and column index on the screen
+ */
+void LCD_displayStringRowColumn_P(uint8 row,uint8 col,const char *str);
+
 /*
  * Description :
  * Display the required integer value on the screen
@@ -107,9 +119,10 @@ void LCD_intgerToString(sint32 data);
 
 /*
  * Description :
- * Display the required float value on the screen
+ * Display the required fixed point value on the screen, the value is data / 10^decimals.
+ * Example : LCD_fixedToString(-1234, 2) displays -12.34
  */
-void LCD_floatToString(float32 data);
+void LCD_fixedToString(sint32 data, uint8 decimals);
 
 /*
  * Description :
@@ -0,0 +1,30 @@
+/*
+ ============================================================================
+ Name        : power.c
+ Author      : Aziza Zamel
+ Description : Source file for the MCU sleep modes
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#include "power.h"
+#include "ATmega32_Registers.h"
+
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for putting the MCU in the sleep mode until the next enabled interrupt.
+ * The sleep enable bit is only set around the sleep instruction, as the data sheet recommends.
+ * The instruction after sei always runs before a pending interrupt, so a caller can disable
+ * the interrupts, check its wake up condition and call this function without missing the interrupt.
+ */
+void Power_sleep(Power_ModeType mode){
+	MCUCR_REG.Bits.SM_bits = mode;
+	MCUCR_REG.Bits.SE_bit = LOGIC_HIGH;
+	__asm__ volatile("sei" "\n\t" "sleep");
+	MCUCR_REG.Bits.SE_bit = LOGIC_LOW;
+}
@@ -0,0 +1,39 @@
+/*
+ ============================================================================
+ Name        : power.h
+ Author      : Aziza Zamel
+ Description : Header file for the MCU sleep modes
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include "std_types.h"
+
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* Values of the SM2:0 bits of MCUCR */
+typedef enum{
+	POWER_IDLE,POWER_ADC_NOISE_REDUCTION,POWER_DOWN,POWER_SAVE,POWER_STANDBY=6,POWER_EXTENDED_STANDBY
+}Power_ModeType;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for putting the MCU in the sleep mode until the next enabled interrupt.
+ * In POWER_IDLE the timers and the UART keep running, so any timer tick wakes it.
+ * The global interrupt is enabled just before the sleep instruction, so an interrupt that comes
+ * after the caller disabled them to check its wake up condition still wakes the MCU.
+ */
+void Power_sleep(Power_ModeType mode);
+
+#endif /* POWER_H_ */
@@ -0,0 +1,77 @@
+/*
+ ============================================================================
+ Name        : spsc_queue.h
+ Author      : Aziza Zamel
+ Description : Ring queue between one producer and one consumer, like an interrupt and the main loop
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef SPSC_QUEUE_H_
+#define SPSC_QUEUE_H_
+
+#include "std_types.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Stops the compiler from moving the element access after the index update */
+#define SPSC_QUEUE_BARRIER()		__asm__ __volatile__("" ::: "memory")
+
+/*
+ * Define the type NAME##Type, a queue of SIZE elements of TYPE, and its functions :
+ * NAME##_init, NAME##_push, NAME##_pop and NAME##_count.
+ * Only the producer writes the head and only the consumer writes the tail. An 8-bit index is read and
+ * written in one instruction, so neither side disables the interrupts.
+ * The indexes run freely and are masked, so SIZE must be a power of two up to 128.
+ * Example : SPSC_QUEUE_DEFINE(UART_RxQueue, uint8, 16) then static UART_RxQueueType g_rxQueue;
+ */
+#define SPSC_QUEUE_DEFINE(NAME, TYPE, SIZE)													\
+typedef struct{																				\
+	TYPE buffer[SIZE];																		\
+	volatile uint8 head;		/* next element to write, changed by the producer only */	\
+	volatile uint8 tail;		/* next element to read, changed by the consumer only */	\
+}NAME##Type;																				\
+																							\
+typedef char NAME##SizeCheck[((((SIZE) & ((SIZE) - 1)) == 0) && ((SIZE) <= 128)) ? 1 : -1];	\
+																							\
+static inline void NAME##_init(NAME##Type * Queue_Ptr){										\
+	Queue_Ptr->head = 0;																	\
+	Queue_Ptr->tail = 0;																	\
+}																							\
+																							\
+/* Called by the producer only, return FALSE and drop the value if the queue is full */		\
+static inline boolean NAME##_push(NAME##Type * Queue_Ptr, TYPE value){						\
+	uint8 head = Queue_Ptr->head;															\
+																							\
+	if((uint8)(head - Queue_Ptr->tail) == (SIZE)){											\
+		return FALSE;																		\
+	}																						\
+	Queue_Ptr->buffer[head & ((SIZE) - 1)] = value;											\
+	SPSC_QUEUE_BARRIER();																	\
+	Queue_Ptr->head = head + 1;																\
+	return TRUE;																			\
+}																							\
+																							\
+/* Called by the consumer only, return FALSE if the queue is empty */						\
+static inline boolean NAME##_pop(NAME##Type * Queue_Ptr, TYPE * value_ptr){					\
+	uint8 tail = Queue_Ptr->tail;															\
+																							\
+	if(tail == Queue_Ptr->head){															\
+		return FALSE;																		\
+	}																						\
+	SPSC_QUEUE_BARRIER();																	\
+	*value_ptr = Queue_Ptr->buffer[tail & ((SIZE) - 1)];									\
+	SPSC_QUEUE_BARRIER();																	\
+	Queue_Ptr->tail = tail + 1;																\
+	return TRUE;																			\
+}																							\
+																							\
+/* Number of elements waiting, exact for the consumer, the producer may add more meanwhile */	\
+static inline uint8 NAME##_count(const NAME##Type * Queue_Ptr){								\
+	return (uint8)(Queue_Ptr->head - Queue_Ptr->tail);										\
+}
+
+#endif /* SPSC_QUEUE_H_ */
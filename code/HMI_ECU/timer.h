@@ -11,6 +11,13 @@
 
 #include "std_types.h"
 
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Number of call back functions each timer can call */
+#define TIMER_MAX_SUBSCRIBERS		2
+
 /*******************************************************************************
  *                         Types Declaration                                   *
  *******************************************************************************/
@@ -28,6 +35,19 @@ typedef enum{
 	OVERFLOW_MODE,COMPARE_MODE=2
 }Timer_ModeType;
 
+/* Drivers that can own a timer, each timer has one owner at a time */
+typedef enum{
+	TIMER_USER_NONE,TIMER_USER_TICK,TIMER_USER_PWM,TIMER_USER_PROBE
+}Timer_UserType;
+
+/* Call back functions are called from the timer interrupt with the context given when they were added */
+typedef void (*Timer_CallBackType)(void * context);
+
+typedef struct{
+	Timer_CallBackType callback;
+	void * context;
+}Timer_SubscriberType;
+
 typedef struct {
 	uint16 timer_InitialValue;
 	uint16 timer_compare_MatchValue;
@@ -49,17 +69,40 @@ typedef struct {
  * 2. Setup Timer compare value in case of compare mode.
  * 3. Select the required prescaler
  * 4. Enable Overflow Interrupt or Compare Match Interrupt
+ * Return FALSE without touching the timer if the user doesn't own it, see Timer_claim.
  */
-void Timer_init(const Timer_ConfigType * Config_Ptr);
+boolean Timer_init(const Timer_ConfigType * Config_Ptr, Timer_UserType user);
 
 /*
- * Description:  Function to disable the Timer via Timer_ID.
+ * Description:  Function to disable the Timer via Timer_ID, its call back functions are removed.
+ * Only the owner of the timer can disable it, it still owns the timer then.
  */
-void Timer_deInit(Timer_ID_Type timer_type);
+void Timer_deInit(Timer_ID_Type timer_type, Timer_UserType user);
 
 /*
- * Description: Function to set the Call Back function address to the required Timer.
+ * Description :
+ * Function responsible for adding a call back function to the timer, it is called with the context on every interrupt.
+ * It is safe to call while the timer interrupt is enabled. Return FALSE if the timer has no free entry.
+ */
+boolean Timer_subscribe(Timer_ID_Type timer_ID, Timer_CallBackType callback, void * context);
+
+/*
+ * Description :
+ * Function responsible for removing the call back function with the context from the timer.
+ */
+void Timer_unsubscribe(Timer_ID_Type timer_ID, Timer_CallBackType callback, void * context);
+
+/*
+ * Description :
+ * Function responsible for giving the timer to the user before it configures the timer.
+ * Return FALSE if another user owns the timer, claiming a timer the user already owns succeeds.
+ */
+boolean Timer_claim(Timer_ID_Type timer_ID, Timer_UserType user);
+
+/*
+ * Description :
+ * Function responsible for stopping the timer and freeing it, only if the user owns it.
  */
-void Timer_setCallBack(void(*a_ptr)(void), Timer_ID_Type a_timer_ID );
+void Timer_release(Timer_ID_Type timer_ID, Timer_UserType user);
 
 #endif /* TIMER_H_ */
@@ -0,0 +1,29 @@
+/*
+ ============================================================================
+ Name        : timer_map.h
+ Author      : Aziza Zamel
+ Description : Hardware timers used by each driver of HMI_ECU
+ Date        : 18/10/2026
+ ============================================================================
+ */
+
+#ifndef TIMER_MAP_H_
+#define TIMER_MAP_H_
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Values of the timer ids for the preprocessor, same as Timer_ID_Type */
+#define TIMER_MAP_TIMER0		0
+#define TIMER_MAP_TIMER1		1
+#define TIMER_MAP_TIMER2		2
+
+/*
+ * Every driver that needs a hardware timer takes it from here, and claims it with Timer_claim at init.
+ * Timer1 and Timer2 are free.
+ */
+#define TIMER_MAP_TICK			TIMER_MAP_TIMER0		/* 1 ms tick that wakes the MCU from idle */
+
+#endif /* TIMER_MAP_H_ */
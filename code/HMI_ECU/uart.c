@@ -12,16 +12,50 @@
 #include "common_macros.h" /* To use the macros like SET_BIT */
 #include "ATmega32_Registers.h" /* To use the UART Registers */
 #include "avr/interrupt.h"
+#include "util/delay.h"
+#include "spsc_queue.h"
+
+/* UART_receiveByteTimeout checks the RXC flag every 10 us */
+#define UART_TIMEOUT_POLL_US		10
+#define UART_TIMEOUT_POLLS_PER_MS	(1000 / UART_TIMEOUT_POLL_US)
 
 #ifdef RX_INTERRUPT
-volatile uint8 g_uartRecievedByte;
-volatile boolean g_uartRecieveFlag = LOGIC_LOW;
+/* The interrupt pushes the received bytes, the receive functions pop them */
+SPSC_QUEUE_DEFINE(UART_RxQueue, uint8, UART_RX_QUEUE_SIZE)
+static UART_RxQueueType g_uartRxQueue;
+
+/* Receiver of the bytes while it is set, like a frame written straight into its buffer */
+static UART_RxHookType g_uartRxHook = NULL_PTR;
+static void * g_uartRxHookContext = NULL_PTR;
+
 ISR(USART_RXC_vect){
-	g_uartRecievedByte = UDR_REG.Byte;
-	g_uartRecieveFlag = LOGIC_HIGH;
+	uint8 data = UDR_REG.Byte;
+
+	if(g_uartRxHook != NULL_PTR)
+	{
+		if(!g_uartRxHook(data, g_uartRxHookContext))
+		{
+			g_uartRxHook = NULL_PTR;
+		}
+	}
+	else
+	{
+		/* The byte is dropped if the queue is full */
+		UART_RxQueue_push(&g_uartRxQueue, data);
+	}
 }
 #endif
 
+/* Set after the first byte is sent, so UART_flush doesn't wait for a TXC flag that will never be set */
+static volatile boolean g_uartTxStarted = FALSE;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static boolean UART_readByte(uint8 *data_ptr);
+
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
@@ -33,15 +67,10 @@ ISR(USART_RXC_vect){
  * 1. Setup the Frame format like number of data bits, parity bit type and number of stop bits.
  * 2. Enable the UART.
  * 3. Setup the UART baud rate.
+ * Return FALSE if the baud rate can't be generated from F_CPU within UART_MAX_BAUD_ERROR_PERMILLE.
  */
-void UART_init(const UART_ConfigType * Config_Ptr)
+boolean UART_init(const UART_ConfigType * Config_Ptr)
 {
-	uint16 ubrr_value = 0;
-
-	/* U2X = 1 for double transmission speed */
-	UCSRA_REG.Bits.U2X_bit = LOGIC_HIGH;
-
-
 	UCSRB_REG.Byte = 0;
 	/* Receiver Enable */
 	UCSRB_REG.Bits.RXEN_bit = LOGIC_HIGH;
@@ -50,6 +79,7 @@ void UART_init(const UART_ConfigType * Config_Ptr)
 
 
 #ifdef RX_INTERRUPT
+	UART_RxQueue_init(&g_uartRxQueue);
 	/* Enable USART RX Complete Interrupt Enable */
 	UCSRB_REG.Bits.RXCIE_bit = LOGIC_HIGH;
 #endif
@@ -67,13 +97,98 @@ void UART_init(const UART_ConfigType * Config_Ptr)
 			| ((Config_Ptr->parity) << UPM0_BIT_POSITION)
 			| ((Config_Ptr->stop_bit) << USBS_BIT_POSITION);
 
+	/* Select the U2X mode and the UBRR value with the lowest error */
+	return UART_setBaudRate(Config_Ptr->baud_rate);
+}
+
+/*
+ * Description :
+ * Function responsible for finding the U2X/UBRR combination with the lowest baud rate error for F_CPU.
+ * Return FALSE if the best combination error is above UART_MAX_BAUD_ERROR_PERMILLE.
+ */
+boolean UART_calculateBaudRate(UART_BaudRateType baud_rate, uint16 * ubrr_ptr, boolean * u2x_ptr)
+{
+	uint8 u2x;
+	uint32 divisor, ubrr_plus_one, actual_rate, error, best_error = 0xFFFFFFFFUL;
+
+	if(baud_rate == 0)
+	{
+		return FALSE;
+	}
 
-	/* Calculate the UBRR register value */
-	ubrr_value = (uint16)( (F_CPU / ((Config_Ptr->baud_rate) * 8UL)) - 1 );
+	/* U2X = 0 divides the clock by 16, U2X = 1 by 8. Try normal speed first so it wins a tie,
+	 * as the receiver takes more samples per bit in this mode */
+	for(u2x = 0 ; u2x < 2 ; u2x++)
+	{
+		divisor = (u2x ? 8UL : 16UL) * baud_rate;
+
+		/* Round to the nearest UBRR instead of truncating */
+		ubrr_plus_one = ((uint32)F_CPU + (divisor / 2)) / divisor;
+		if((ubrr_plus_one == 0) || (ubrr_plus_one > (UART_MAX_UBRR_VALUE + 1UL)))
+		{
+			continue;
+		}
+
+		/* Error between the generated and the required baud rate in per-mille */
+		actual_rate = (uint32)F_CPU / ((u2x ? 8UL : 16UL) * ubrr_plus_one);
+		error = (actual_rate > baud_rate) ? (actual_rate - baud_rate) : (baud_rate - actual_rate);
+		error = (error * 1000UL) / baud_rate;
+
+		if(error < best_error)
+		{
+			best_error = error;
+			*ubrr_ptr = (uint16)(ubrr_plus_one - 1);
+			*u2x_ptr = u2x;
+		}
+	}
+
+	return (best_error <= UART_MAX_BAUD_ERROR_PERMILLE) ? TRUE : FALSE;
+}
+
+/*
+ * Description :
+ * Function responsible for changing the UART baud rate at run time.
+ * Return FALSE and keep the current baud rate if the required one is not supported.
+ */
+boolean UART_setBaudRate(UART_BaudRateType baud_rate)
+{
+	uint16 ubrr_value = 0;
+	boolean u2x = FALSE;
+
+	if(!UART_calculateBaudRate(baud_rate, &ubrr_value, &u2x))
+	{
+		return FALSE;
+	}
+
+	/* Don't corrupt a byte that is still being sent with the old rate */
+	UART_flush();
+	/* Nothing is being sent now, so the next UART_flush doesn't wait for a TXC flag cleared below */
+	g_uartTxStarted = FALSE;
+
+	/*
+	 * U2X = 1 for double transmission speed. UCSRA is written as a whole byte with TXC = 0,
+	 * a read-modify-write of the U2X bit would write back TXC = 1, which clears the flag
+	 */
+	UCSRA_REG.Byte = (uint8)(u2x << U2X_BIT_POSITION);
 
 	/* First 8 bits from the BAUD_PRESCALE inside UBRRL and last 4 bits in UBRRH*/
 	UBRRH_REG.Byte = ubrr_value>>8;
 	UBRRL_REG.Byte = ubrr_value;
+
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Function responsible for waiting until all the sent bytes left the transmit shift register.
+ */
+void UART_flush(void)
+{
+	if(g_uartTxStarted)
+	{
+		/* TXC flag is set when the last byte is shifted out and there is no new data in UDR */
+		while(UCSRA_REG.Bits.TXC_bit == LOGIC_LOW){}
+	}
 }
 
 /*
@@ -87,6 +202,11 @@ void UART_sendByte(const uint8 data)
 	 * transmitting a new byte so wait until this flag is set to one
 	 */
 	while(UCSRA_REG.Bits.UDRE_bit == LOGIC_LOW){}
+
+	/* Clear TXC flag by writing one to it, so UART_flush waits for this byte too */
+	UCSRA_REG.Bits.TXC_bit = LOGIC_HIGH;
+	g_uartTxStarted = TRUE;
+
 	/*
 	 * Put the required data in the UDR register and it also clear the UDRE flag as
 	 * the UDR register is not empty now
@@ -95,49 +215,112 @@ void UART_sendByte(const uint8 data)
 	UDR_REG.Byte = data;
 }
 
-
-#ifndef RX_INTERRUPT
-
 /*
  * Description :
  * Function responsible for receive byte from another UART device.
  */
 uint8 UART_recieveByte(void)
 {
-	/* RXC flag is set when the UART receive data so wait until this flag is set to one */
-	while(UCSRA_REG.Bits.RXC_bit == LOGIC_LOW){}
+	uint8 data;
 
-	/*
-	 * Read the received data from the Rx buffer (UDR)
-	 * The RXC flag will be cleared after read the data
-	 */
-    return UDR_REG.Byte;
+	/* Wait until a byte is received */
+	while(!UART_readByte(&data)){}
+
+	return data;
+}
+
+/*
+ * Description :
+ * Function responsible for checking if a received byte is waiting, without blocking.
+ */
+boolean UART_isByteReceived(void)
+{
+#ifdef RX_INTERRUPT
+	return (UART_RxQueue_count(&g_uartRxQueue) != 0);
+#else
+	return (UCSRA_REG.Bits.RXC_bit == LOGIC_HIGH);
+#endif
+}
+
+/*
+ * Description :
+ * Function responsible for receive byte from another UART device, waiting at most timeout_ms milliseconds.
+ * Return FALSE if no byte was received in time.
+ */
+boolean UART_receiveByteTimeout(uint8 *data_ptr, uint16 timeout_ms)
+{
+	uint32 polls = (uint32)timeout_ms * UART_TIMEOUT_POLLS_PER_MS;
+
+	while(!UART_readByte(data_ptr))
+	{
+		if(polls == 0)
+		{
+			return FALSE;
+		}
+		polls--;
+		_delay_us(UART_TIMEOUT_POLL_US);
+	}
+	return TRUE;
 }
 
 /*
  * Description :
  * Receive the required string until the '#' symbol through UART from the other UART device.
+ * At most max_length - 1 characters are stored, the rest of the string is received and dropped,
+ * and the string always ends with '\0'. Return the number of characters stored.
  */
-void UART_receiveString(uint8 *Str)
+uint8 UART_receiveString(uint8 *Str, uint8 max_length)
 {
 	uint8 i = 0;
+	uint8 data;
 
-	/* Receive the first byte */
-	Str[i] = UART_recieveByte();
+	if(max_length == 0)
+	{
+		return 0;
+	}
 
 	/* Receive the whole string until the '#' */
-	while(Str[i] != '#')
+	data = UART_recieveByte();
+	while(data != '#')
 	{
-		i++;
-		Str[i] = UART_recieveByte();
+		if(i < (max_length - 1))
+		{
+			Str[i++] = data;
+		}
+		data = UART_recieveByte();
 	}
 
-	/* After receiving the whole string plus the '#', replace the '#' with '\0' */
+	/* Replace the '#' with '\0' */
 	Str[i] = '\0';
+	return i;
 }
 
-#endif
 
+#ifdef RX_INTERRUPT
+/*
+ * Description :
+ * Function responsible for giving the received bytes to the hook instead of the RX queue, until it returns FALSE.
+ * The bytes already waiting in the queue are given first. NULL_PTR removes the hook.
+ */
+void UART_setRxHook(UART_RxHookType hook, void * context)
+{
+	uint8 interrupts = SREG_REG.bits.I_bit;
+	uint8 data;
+
+	/* The interrupt must not take a byte before the older ones waiting in the queue */
+	SREG_REG.bits.I_bit = LOGIC_LOW;
+	g_uartRxHookContext = context;
+	g_uartRxHook = hook;
+	while((g_uartRxHook != NULL_PTR) && UART_RxQueue_pop(&g_uartRxQueue, &data))
+	{
+		if(!g_uartRxHook(data, g_uartRxHookContext))
+		{
+			g_uartRxHook = NULL_PTR;
+		}
+	}
+	SREG_REG.bits.I_bit = interrupts;
+}
+#endif
 
 /*
  * Description :
@@ -153,3 +336,26 @@ void UART_sendString(const uint8 *Str)
 
 }
 
+/*
+ * Description :
+ * Take the received byte without waiting, from the RX queue or from UDR. Return FALSE if there is none.
+ */
+static boolean UART_readByte(uint8 *data_ptr)
+{
+#ifdef RX_INTERRUPT
+	return UART_RxQueue_pop(&g_uartRxQueue, data_ptr);
+#else
+	/* RXC flag is set when the UART receive data */
+	if(UCSRA_REG.Bits.RXC_bit == LOGIC_LOW)
+	{
+		return FALSE;
+	}
+
+	/*
+	 * Read the received data from the Rx buffer (UDR)
+	 * The RXC flag will be cleared after read the data
+	 */
+	*data_ptr = UDR_REG.Byte;
+	return TRUE;
+#endif
+}